@@ -0,0 +1,96 @@
+#include "CellIndex.h"
+#include <algorithm>
+using namespace std;
+
+static size_t hashCellKey(uint64_t key) {
+    // splitmix64的混合函数
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<size_t>(key ^ (key >> 31));
+}
+
+CellIndex::CellIndex(int minCoord, int maxCoord, pmr::memory_resource* resource)
+    : minCoord(minCoord), width(0), dense(resource), hashKeys(resource), hashValues(resource), hashCount(0) {
+    if (maxCoord >= minCoord) {
+        width = maxCoord - minCoord + 1;
+        dense.assign(static_cast<size_t>(width) * width, -1);
+    }
+}
+
+CellIndex::CellIndex() : CellIndex(pmr::get_default_resource()) {
+}
+
+CellIndex::CellIndex(pmr::memory_resource* resource)
+    : minCoord(0), width(0), dense(resource), hashKeys(resource), hashValues(resource), hashCount(0) {
+}
+
+void CellIndex::clear() {
+    fill(dense.begin(), dense.end(), -1);
+    if (hashCount > 0) {
+        fill(hashKeys.begin(), hashKeys.end(), EMPTY_KEY);
+        fill(hashValues.begin(), hashValues.end(), -1);
+        hashCount = 0;
+    }
+}
+
+size_t CellIndex::findSlot(uint64_t key) const {
+    // 线性探测，返回key所在槽位或第一个空槽位
+    size_t mask = hashKeys.size() - 1;
+    size_t slot = hashCellKey(key) & mask;
+    while (hashKeys[slot] != key && hashKeys[slot] != EMPTY_KEY) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void CellIndex::growHash() {
+    // 负载因子超过1/2时容量翻倍并重新插入
+    pmr::vector<uint64_t> oldKeys(hashKeys.get_allocator());
+    pmr::vector<int32_t> oldValues(hashValues.get_allocator());
+    oldKeys.swap(hashKeys);
+    oldValues.swap(hashValues);
+
+    size_t capacity = oldKeys.empty() ? 32 : oldKeys.size() * 2;
+    hashKeys.assign(capacity, EMPTY_KEY);
+    hashValues.assign(capacity, -1);
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldKeys[i] != EMPTY_KEY) {
+            size_t slot = findSlot(oldKeys[i]);
+            hashKeys[slot] = oldKeys[i];
+            hashValues[slot] = oldValues[i];
+        }
+    }
+}
+
+long CellIndex::indexOfHashed(const GridCell& cell) const {
+    if (hashCount == 0) {
+        return -1;
+    }
+    return hashValues[findSlot(cell.key())];
+}
+
+void CellIndex::insertHashed(const GridCell& cell, long index) {
+    if ((hashCount + 1) * 2 > hashKeys.size()) {
+        growHash();
+    }
+    size_t slot = findSlot(cell.key());
+    if (hashKeys[slot] == EMPTY_KEY) {
+        hashKeys[slot] = cell.key();
+        hashCount++;
+    }
+    if (hashValues[slot] < 0) {
+        hashValues[slot] = static_cast<int32_t>(index);
+    }
+}
+
+void CellIndex::eraseHashed(const GridCell& cell, long index) {
+    // 只把下标置为-1，槽位本身保留，避免开放寻址表的删除开销
+    if (hashCount == 0) {
+        return;
+    }
+    size_t slot = findSlot(cell.key());
+    if (hashValues[slot] == index) {
+        hashValues[slot] = -1;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "GridCell.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 轨迹格子的位置索引：记录每个格子在轨迹中第一次出现的下标，contains/indexOf均为O(1)
+// 有界棋盘使用稠密数组；超出边界的格子（或无界棋盘）退回到开放寻址哈希表
+// 只支持按轨迹顺序插入、按相反顺序删除（与Trajectory的addCell/removeLastCell一致）
+class CellIndex {
+private:
+    int minCoord;                   // 稠密数组覆盖的最小坐标
+    int width;                      // 稠密数组边长，0表示没有稠密部分
+    std::pmr::vector<int32_t> dense;     // 每个格子第一次出现的下标，-1表示不在轨迹上
+
+    // 哈希回退：key为GridCell::key()，value为下标，-1表示已删除（槽位保留）
+    std::pmr::vector<uint64_t> hashKeys;
+    std::pmr::vector<int32_t> hashValues;
+    size_t hashCount;
+
+    static constexpr uint64_t EMPTY_KEY = 0x8000000080000000ULL;
+
+    // 稠密数组中的位置，不在范围内返回-1
+    long denseIndex(const GridCell& cell) const {
+        int r = cell.getRow() - minCoord;
+        int c = cell.getCol() - minCoord;
+        if (width == 0 || r < 0 || r >= width || c < 0 || c >= width) {
+            return -1;
+        }
+        return static_cast<long>(r) * width + c;
+    }
+
+    size_t findSlot(uint64_t key) const;
+    void growHash();
+    long indexOfHashed(const GridCell& cell) const;
+    void insertHashed(const GridCell& cell, long index);
+    void eraseHashed(const GridCell& cell, long index);
+
+public:
+    // 构造函数：稠密数组覆盖[minCoord, maxCoord]范围内的正方形棋盘，数组和哈希表从resource分配
+    CellIndex(int minCoord, int maxCoord, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // 构造函数：无界棋盘，全部走哈希表（空索引不分配内存）
+    CellIndex();
+    explicit CellIndex(std::pmr::memory_resource* resource);
+
+    // 分配稠密数组和哈希表的内存资源
+    std::pmr::memory_resource* getResource() const {
+        return dense.get_allocator().resource();
+    }
+
+    // 格子第一次出现的下标，不在轨迹上返回-1
+    long indexOf(const GridCell& cell) const {
+        long position = denseIndex(cell);
+        if (position < 0) {
+            return indexOfHashed(cell);
+        }
+        return dense[position];
+    }
+
+    bool contains(const GridCell& cell) const {
+        return indexOf(cell) >= 0;
+    }
+
+    // 记录格子出现在下标index处，已经出现过时保留更早的下标
+    void insert(const GridCell& cell, long index) {
+        long position = denseIndex(cell);
+        if (position < 0) {
+            insertHashed(cell, index);
+            return;
+        }
+        if (dense[position] < 0) {
+            dense[position] = static_cast<int32_t>(index);
+        }
+    }
+
+    // 删除下标index处的格子，只有它是第一次出现时才真正移除
+    void erase(const GridCell& cell, long index) {
+        long position = denseIndex(cell);
+        if (position < 0) {
+            eraseHashed(cell, index);
+            return;
+        }
+        if (dense[position] == index) {
+            dense[position] = -1;
+        }
+    }
+
+    // 清空索引（保留已分配的空间）
+    void clear();
+};
@@ -8,7 +8,9 @@ using namespace std;
 const int step=5;
 
 GameManager::GameManager() 
-    : currentPlayerIndex(-1), currentGameMode(SIMPLE_SINGLE), 
+    : puzzle(std::make_shared<GameObject>()), rng(RandomEngine::randomSeed()), puzzleSeed(0),
+      prefetchedComplex(false), prefetchedSteps(0), prefetchedSeed(0),
+      currentPlayerIndex(-1), currentGameMode(SIMPLE_SINGLE), 
       gameSteps(10), gameRunning(false), 
       currentRound(0), totalRounds(2), isLoggedIn(false) {
     // 初始化GameManager对象
@@ -67,22 +69,11 @@ bool GameManager::CheakIfUserExist(fstream&userInfoFile,string username) {
 
 void GameManager::generateGameData() {
     // 生成实际轨迹和相对轨迹
-    if (isMultiplayerMode() && currentPlayerIndex > 0) {
-        // 在多人模式的第二个玩家时，使用和第一个玩家相同的轨迹数据
-        objectA = sharedObjectA;
-    } else {
-        // 单人模式或多人模式第一个玩家时，生成新的轨迹
-        objectA.generateTrajectory(isComplexMode(), gameSteps);
-        do{objectA.generateRelativeTrajectory(gameSteps, isComplexMode());
-        }while((abs(objectA.getActualTrajectory().getCell(0).getRow()-objectA.getRelativeTrajectory().getCell(0).getRow())<5)&&
-        (abs(objectA.getActualTrajectory().getCell(0).getCol()-objectA.getRelativeTrajectory().getCell(0).getCol())<5));
-        
-        objectA.calculateActualTrajectory();
-        
-        // 在多人模式下，保存第一个玩家的轨迹数据供第二个玩家使用
-        if (isMultiplayerMode() && currentPlayerIndex == 0) {
-            sharedObjectA = objectA;
-        }
+    // 在多人模式的第二个玩家时，继续使用第一个玩家的谜题（共享同一份，无需复制）
+    if (!isMultiplayerMode() || currentPlayerIndex <= 0) {
+        // 单人模式或多人模式第一个玩家时，换上新的轨迹，并在后台准备下一局
+        installNextPuzzle();
+        prefetchNextPuzzle();
     }
 }
 
@@ -98,14 +89,80 @@ void GameManager::startNewRound() {
     
     // 生成新的游戏数据
     // 这里应该总是生成新数据，因为这是开始新的一轮
-    objectA.generateTrajectory(isComplexMode(), gameSteps);
-    objectA.generateRelativeTrajectory(gameSteps, isComplexMode());
-    objectA.calculateActualTrajectory();
-    
-    // 在多人模式下，保存第一个玩家的轨迹数据供后续玩家使用
-    if (isMultiplayerMode()) {
-        sharedObjectA = objectA;
+    // 多人模式下后续玩家共享这一局的谜题
+    // 换下来的谜题释放后，它的内存池在预生成下一局时重置复用
+    installNextPuzzle();
+    prefetchNextPuzzle();
+}
+
+void GameManager::installNextPuzzle() {
+    if (prefetchedPuzzle.valid()) {
+        // 等待后台生成结束（通常早已完成），只有模式和步数一致时才能直接换上
+        std::shared_ptr<const GameObject> next = prefetchedPuzzle.get();
+        if (prefetchedComplex == isComplexMode() && prefetchedSteps == gameSteps &&
+            prefetchedOptions == generationOptions) {
+            puzzle = std::move(next);
+            puzzleSeed = prefetchedSeed;
+            return;
+        }
+    }
+
+    // 没有可用的预生成谜题，同步生成
+    puzzleSeed = rng.next();
+    std::shared_ptr<GameObject> next = std::make_shared<GameObject>(acquireArena());
+    next->setGenerationOptions(generationOptions);
+    next->setSeed(puzzleSeed);
+    next->generatePuzzle(isComplexMode(), gameSteps);
+    puzzle = std::move(next);
+}
+
+void GameManager::prefetchNextPuzzle() {
+    // 种子在游戏线程中按顺序派生，预生成不改变谜题序列
+    prefetchedComplex = isComplexMode();
+    prefetchedSteps = gameSteps;
+    prefetchedOptions = generationOptions;
+    prefetchedSeed = rng.next();
+
+    bool complex = prefetchedComplex;
+    int steps = prefetchedSteps;
+    GenerationOptions options = prefetchedOptions;
+    uint64_t seed = prefetchedSeed;
+    // 内存池在游戏线程中取出并重置，之后只有工作线程在其中分配，直到谜题交回游戏线程
+    std::shared_ptr<RoundArena> arena = acquireArena();
+    prefetchedPuzzle = std::async(std::launch::async, [complex, steps, options, seed, arena]() {
+        // 工作线程使用独立的GameObject，不访问GameManager的任何状态
+        std::shared_ptr<GameObject> next = std::make_shared<GameObject>(arena);
+        next->setGenerationOptions(options);
+        next->setSeed(seed);
+        next->generatePuzzle(complex, steps);
+        return std::shared_ptr<const GameObject>(std::move(next));
+    });
+}
+
+std::shared_ptr<RoundArena> GameManager::acquireArena() {
+    // 除了arenas，只有谜题（和正在生成它的工作线程）持有内存池，引用计数为1说明已经没有谜题在使用它
+    for (const std::shared_ptr<RoundArena>& arena : arenas) {
+        if (arena.use_count() == 1) {
+            arena->reset();
+            return arena;
+        }
+    }
+    arenas.push_back(std::make_shared<RoundArena>());
+    return arenas.back();
+}
+
+void GameManager::setGenerationOptions(const GenerationOptions& options) {
+    // 在这里就拒绝无法生成谜题的选项，不让错误推迟到后台预生成的线程里
+    GameObject::validateGenerationOptions(options);
+    generationOptions = options;
+}
+
+void GameManager::setSeed(uint64_t seedValue) {
+    // 重新设置随机种子，丢弃按旧种子预生成的谜题
+    if (prefetchedPuzzle.valid()) {
+        prefetchedPuzzle.get();
     }
+    rng.seed(seedValue);
 }
 
 void GameManager::updateTotalRounds(int rounds){
@@ -192,7 +249,11 @@ Player& GameManager::getCurrentPlayer() {
 
 const GameObject& GameManager::getObjectA() const {
     // 返回ObjectA
-    return objectA;
+    return *puzzle;
+}
+
+std::shared_ptr<const GameObject> GameManager::getSharedPuzzle() const {
+    return puzzle;
 }
 
 bool GameManager::isGameRunning() const {
@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <future>
+#include <memory>
 
 class GameManager {
 public:
@@ -17,8 +19,21 @@ public:
     };
 
 private:
-    GameObject objectA;
-    GameObject sharedObjectA; // 用于在多人模式下共享轨迹数据
+    // 当前谜题，生成后不再修改；多人模式下所有玩家共享同一份，不做复制
+    std::shared_ptr<const GameObject> puzzle;
+    RandomEngine rng;         // 为每局谜题派生种子的随机数引擎
+    uint64_t puzzleSeed;      // 当前谜题的种子，可用于复现谜题
+
+    // 每局谜题使用的内存池；谜题（以及通过getSharedPuzzle持有它的调用方）全部释放后，内存池在下一局重置并复用
+    std::vector<std::shared_ptr<RoundArena>> arenas;
+
+    // 后台预生成的下一局谜题，在当前玩家输入预测时由工作线程生成
+    std::future<std::shared_ptr<const GameObject>> prefetchedPuzzle;
+    GenerationOptions generationOptions;    // 谜题生成选项
+    bool prefetchedComplex;   // 预生成谜题使用的模式
+    GenerationOptions prefetchedOptions;    // 预生成谜题使用的生成选项
+    int prefetchedSteps;      // 预生成谜题使用的步数
+    uint64_t prefetchedSeed;  // 预生成谜题使用的种子
     std::vector<Player> players;
     int currentPlayerIndex;
     GameMode currentGameMode;
@@ -50,6 +65,15 @@ private:
     // 新增方法
     void updateUserStats(const std::string& username, bool isComplexMode, bool isWin);
 
+    // 换上下一局谜题：优先使用后台预生成的结果，配置不符时同步生成
+    void installNextPuzzle();
+
+    // 在后台线程中预生成下一局谜题
+    void prefetchNextPuzzle();
+
+    // 取一个空闲的内存池并重置；全部内存池都还被谜题占用时新建一个
+    std::shared_ptr<RoundArena> acquireArena();
+
 public:
     // 构造函数
     GameManager();
@@ -63,6 +87,17 @@ public:
     // 生成游戏数据（A和B的轨迹等）
     void generateGameData();
 
+    // 设置随机种子，相同种子下整场游戏的谜题序列可以复现
+    void setSeed(uint64_t seedValue);
+
+    // 设置谜题生成选项（起点间隔、起点采样方式等），从下一局开始生效；选项无法生成谜题时抛出std::invalid_argument
+    void setGenerationOptions(const GenerationOptions& options);
+
+    // 获取当前谜题的种子
+    uint64_t getPuzzleSeed() const {
+        return puzzleSeed;
+    }
+
     // 设置轨迹步数
     void setGameSteps(int steps);
     
@@ -102,6 +137,9 @@ public:
     
     // 获取ObjectA
     const GameObject& getObjectA() const;
+
+    // 获取当前谜题的共享所有权，谜题在持有者释放前一直有效（即使已经换到下一局）
+    std::shared_ptr<const GameObject> getSharedPuzzle() const;
     
     
     // 检查游戏是否在运行
@@ -1,57 +1,116 @@
 #include "GameObject.h"
+#include "Lattice.h"
 #include <cmath>
-#include <ctime>  // 添加ctime头文件用于time函数
-#include <cstdlib> // 添加cstdlib头文件用于rand函数
+#include <cstdlib> // 添加cstdlib头文件用于abs函数
 #include <algorithm> // 添加algorithm头文件用于std::min函数
 #include <vector>
 #include<iostream>
+#include <stdexcept>
+#include <atomic>
 
 using namespace std;
 
-// 坐标范围常量
-const int MIN_TRAJ_COORD = -15;
-const int MAX_TRAJ_COORD = 15;
-
-const vector<GridCell>hex_point={
-    GridCell(0, -2),
-    GridCell(0, 2),
-    GridCell(-1, 1),
-    GridCell(-1, -1),
-    GridCell(1, 1),
-    GridCell(1, -1),
-    GridCell(-1,0),
-    GridCell(1,0)
-};
-const vector<GridCell>four_directions={
-    GridCell(-1, 0),
-    GridCell(0, 1),
-    GridCell(0, -1),
-    GridCell(1, 0)
-    
-};
-const vector<GridCell>hex_directions={
-    GridCell(-2,0),
-    GridCell(-1,-3),
-    GridCell(1, -3),
-    GridCell(2, 0),
-    GridCell(1, 3),
-    GridCell(-1, 3)
+// 版本号计数器：谜题可能在预生成线程中构造，因此使用原子变量
+static atomic<uint64_t> revisionCounter(0);
+
+// 回溯栈的容量：自回避轨迹的长度不会超过棋盘格子总数
+const int MAX_BACKTRACK_FRAMES = (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1) * (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1);
+
+// 回溯栈帧：当前单元格 + 按打乱顺序排列的待尝试方向（每个方向占3位）
+struct BacktrackFrame {
+    GridCell cell;
+    int lastDir;
+    unsigned int pendingDirs;
+    int pendingCount;
 };
-const int UP = 0;
-const int RIGHT = 1;
-const int LEFT = 2;
-const int DOWN = 3;
-const int UP_RIGHT = 5;
-const int DOWN_RIGHT = 4;
-const int DOWN_LEFT = 2;
-const int UP_LEFT = 1;
 
+// 初始化栈帧并随机打乱方向顺序
+template <class Lattice>
+static void initBacktrackFrame(BacktrackFrame& frame, const GridCell& cell, int lastDir, RandomEngine& rng) {
+    const int numDirs = Lattice::DIRECTION_COUNT;
+    int directions[numDirs];
+    for (int i = 0; i < numDirs; i++) {
+        directions[i] = i;
+    }
+    for (int i = 0; i < numDirs; i++) {
+        int j = rng.nextInt(numDirs);
+        swap(directions[i], directions[j]);
+    }
+
+    frame.cell = cell;
+    frame.lastDir = lastDir;
+    frame.pendingDirs = 0;
+    for (int i = numDirs - 1; i >= 0; i--) {
+        frame.pendingDirs = (frame.pendingDirs << 3) | directions[i];
+    }
+    frame.pendingCount = numDirs;
+}
+
+
+GameObject::GameObject(int startRow, int startCol, const std::string& objectColor)
+    : GameObject(nullptr, startRow, startCol) {
+}
 
-GameObject::GameObject(int startRow, int startCol, const std::string& objectColor) {
+GameObject::GameObject(shared_ptr<RoundArena> roundArena, int startRow, int startCol)
+    : arena(std::move(roundArena)), actualTrajectory(getMemoryResource()), relativeTrajectory(getMemoryResource()),
+      predictedTrajectory(getMemoryResource()), finalTrajectory(getMemoryResource()), finalStart(0, 0),
+      revision(0), visitedCells(MIN_TRAJ_COORD, MAX_TRAJ_COORD, getMemoryResource()),
+      floodSeen(MIN_TRAJ_COORD, MAX_TRAJ_COORD, getMemoryResource()), floodQueue(getMemoryResource()),
+      sampledWalk(getMemoryResource()), rng(RandomEngine::randomSeed()) {
     // 初始化游戏对象，设置起始位置和颜色
     // 将起始位置添加到实际轨迹中
     GridCell initialCell(startRow, startCol);
     actualTrajectory.addCell(initialCell);
+    bumpRevision();
+}
+
+void GameObject::bumpRevision() {
+    revision = revisionCounter.fetch_add(1, memory_order_relaxed) + 1;
+}
+
+uint64_t GameObject::getRevision() const {
+    return revision;
+}
+
+pmr::memory_resource* GameObject::getMemoryResource() const {
+    return arena ? arena->getResource() : pmr::get_default_resource();
+}
+
+pmr::memory_resource* GameObject::getScratchResource() const {
+    return arena ? arena->getScratchResource() : pmr::get_default_resource();
+}
+
+void GameObject::validateGenerationOptions(const GenerationOptions& generationOptions) {
+    // 实际轨迹的起点在棋盘中央时离边缘最近，此时最多能在一个坐标轴上相距MAX_START_SEPARATION格
+    if (generationOptions.minStartSeparation > MAX_START_SEPARATION) {
+        throw std::invalid_argument("起点间隔过大，棋盘上没有合法的起点");
+    }
+    if (generationOptions.walkStrategy == TABLE_SAMPLED_WALK && !generationOptions.walkTable) {
+        throw std::invalid_argument("按轨迹表生成时必须提供轨迹表");
+    }
+}
+
+void GameObject::setGenerationOptions(const GenerationOptions& generationOptions) {
+    validateGenerationOptions(generationOptions);
+    options = generationOptions;
+}
+
+const GenerationOptions& GameObject::getGenerationOptions() const {
+    return options;
+}
+
+void GameObject::setSeed(uint64_t seedValue) {
+    // 重新设置随机种子，之后生成的轨迹完全由该种子决定
+    rng.seed(seedValue);
+}
+
+void GameObject::setRandomEngine(const RandomEngine& engine) {
+    // 注入外部的随机数引擎
+    rng = engine;
+}
+
+RandomEngine& GameObject::getRandomEngine() {
+    return rng;
 }
 
 const GridCell& GameObject::getCurrentCell(Trajectory&trajectory) const {
@@ -61,47 +120,12 @@ const GridCell& GameObject::getCurrentCell(Trajectory&trajectory) const {
     
 
 void GameObject::addCellBasedOnDirection(Trajectory& trajectory,const GridCell& cell, int direction, bool isSixDirection) {
-    GridCell x;
-    
+    // 方向表由格点策略提供，不再逐个方向写switch
     if (isSixDirection) {
-        switch (direction) {
-            case UP_RIGHT:
-                x = cell+hex_directions[UP_RIGHT];
-                break;
-            case DOWN_RIGHT:
-                x = cell+hex_directions[DOWN_RIGHT];
-                break;
-            case DOWN:
-                x = cell+hex_directions[DOWN];
-                break;
-            case DOWN_LEFT:
-                x = cell+hex_directions[DOWN_LEFT];
-                break;
-            case UP_LEFT:
-                x = cell+hex_directions[UP_LEFT];
-                break;
-            case UP:
-                x = cell+hex_directions[UP];
-                break;  
-        }
+        trajectory.addCell(latticeStep<HexLattice6>(cell, direction));
     } else {
-        switch (direction) {
-            case RIGHT:
-                x = cell+four_directions[RIGHT];
-                break;
-            case UP:
-                x = cell+four_directions[UP];
-                break;
-            case LEFT:
-                x = cell+four_directions[LEFT];
-                break;
-            case DOWN:
-                x = cell+four_directions[DOWN];
-                break;
-        }
+        trajectory.addCell(latticeStep<SquareLattice4>(cell, direction));
     }
-    
-    trajectory.addCell(x);
 }
 
 void GameObject::removeFourDirection(Trajectory& trajectory,const GridCell& cell, int direction) {
@@ -112,31 +136,21 @@ void GameObject::removeSixDirection(Trajectory& trajectory,const GridCell& cell,
     addCellBasedOnDirection(trajectory,cell, direction, true);
 }
 
-bool checkIfExist(const Trajectory&trajectory,GridCell newgrid,const int direction,bool ISCOMPLEX){
-    int i=trajectory.getLength();
-    int value=0;
-    if(ISCOMPLEX){
-        for(int j=0;j<i;j++){
-        if(trajectory.getCell(j)==(newgrid+hex_directions[direction])) value=1;}
-    }
-    else{
-    for(int j=0;j<i;j++){
-        if(trajectory.getCell(j)==(newgrid+four_directions[direction])) value=1;
-    }
-    }
-    return value;
+template <class Lattice>
+static bool checkIfExist(const OccupancyGrid&visited,const GridCell& newgrid,const int direction){
+    // 通过占用表O(1)判断移动后的位置是否已在轨迹中
+    return visited.contains(latticeStep<Lattice>(newgrid, direction));
 }
 
 void GameObject::generateTrajectory(bool difficulty, int steps) {
-    // 添加随机种子刷新，确保每次调用都获得新的随机序列
-    srand(static_cast<unsigned int>(time(nullptr) * rand()));
-    
         // 清空现有轨迹
         actualTrajectory.clear();
+        bumpRevision();
+        actualTrajectory.reserve(steps + 1);
 
         // 生成随机初始坐标（范围-15到15）
-        int startRow = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-        int startCol = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
+        int startRow = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
+        int startCol = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
         GridCell startCell(startRow, startCol);
         actualTrajectory.addCell(startCell);
 
@@ -145,9 +159,7 @@ void GameObject::generateTrajectory(bool difficulty, int steps) {
     bool success = false;
     
     for (int attempt = 0; attempt < maxAttempts && !success; attempt++) {
-        // 每次尝试使用新的随机种子
-        srand(static_cast<unsigned int>(time(nullptr) * rand() + attempt));
-        success = generateTrajectoryBacktrack(actualTrajectory, 0, steps, -1, difficulty);
+        success = generateWalk(actualTrajectory, steps, difficulty);
         
         if (!success && attempt < maxAttempts - 1) {
             // 如果失败且还有尝试机会，清空轨迹并重新添加起始点
@@ -193,16 +205,17 @@ void GameObject::generateTrajectory(bool difficulty, int steps) {
 }
 
 void GameObject::generateRelativeTrajectory(int steps, bool difficulty) {
-    // 添加随机种子刷新，确保每次调用都获得新的随机序列
-    srand(static_cast<unsigned int>(time(nullptr) * rand() + 12345));
-    
+    // 生成随机初始坐标（范围-15到15）
+    int startRow = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
+    int startCol = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
+    generateRelativeTrajectoryFrom(GridCell(startRow, startCol), steps, difficulty);
+}
+
+void GameObject::generateRelativeTrajectoryFrom(const GridCell& startCell, int steps, bool difficulty) {
     // 清空现有相对轨迹
     relativeTrajectory.clear();
-    
-    // 生成随机初始坐标（范围-15到15）
-    int startRow = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-    int startCol = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-    GridCell startCell(startRow, startCol);
+    bumpRevision();
+    relativeTrajectory.reserve(steps + 1);
     relativeTrajectory.addCell(startCell);
     
     // 使用回溯算法生成轨迹
@@ -210,9 +223,7 @@ void GameObject::generateRelativeTrajectory(int steps, bool difficulty) {
     bool success = false;
     
     for (int attempt = 0; attempt < maxAttempts && !success; attempt++) {
-        // 每次尝试使用新的随机种子
-        srand(static_cast<unsigned int>(time(nullptr) * rand() + 54321 + attempt));
-        success = generateTrajectoryBacktrack(relativeTrajectory, 0, steps, -1, difficulty);
+        success = generateWalk(relativeTrajectory, steps, difficulty);
         
         if (!success && attempt < maxAttempts - 1) {
             // 如果失败且还有尝试机会，清空轨迹并重新添加起始点
@@ -260,9 +271,6 @@ void GameObject::generateRelativeTrajectory(int steps, bool difficulty) {
     
 
 void GameObject::calculateActualTrajectory() {
-    // 添加随机种子刷新，确保每次调用都获得新的随机起点
-    srand(static_cast<unsigned int>(time(nullptr) * rand() + 67890));
-    
     // 清空现有实际轨迹
     finalTrajectory.clear();
     
@@ -275,22 +283,114 @@ void GameObject::calculateActualTrajectory() {
         return;
     }
     
-    // 随机生成实际轨迹的起始点（范围-15到15）
-double startRow = (rand()% (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-double startCol = (rand()% (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-finalTrajectory.addCell(GridCell(startRow, startCol));
-    
-    // 使用四方向移动生成实际轨迹，确保每次只移动1个单位
-    int lastDirection = -1;
-    int minLength = min(actLength, relLength);
-    for(int i=1;i<minLength;i++){
-        GridCell newCell = finalTrajectory.getCurrentCell()+
-                         actualTrajectory.getCell(i)-actualTrajectory.getCell(i-1)+
-                         relativeTrajectory.getCell(i)-relativeTrajectory.getCell(i-1);
-        
-        
-        finalTrajectory.addCell(newCell);
+    // 随机生成实际轨迹的起始点（范围-15到15），再立即逐格合成
+    // 谜题生成后以shared_ptr<const GameObject>在线程间共享，之后不能再修改
+    int startRow = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
+    int startCol = rng.nextInt(MIN_TRAJ_COORD, MAX_TRAJ_COORD);
+    finalStart = GridCell(startRow, startCol);
+    composeFinalTrajectory();
+}
+
+void GameObject::composeFinalTrajectory() {
+    // 每一步的位移是两条轨迹位移之和，前缀和抵消后得到
+    // final[i] = start + (actual[i] - actual[0]) + (relative[i] - relative[0])
+    // 每个格子互不依赖，循环在连续的坐标上逐元素计算，编译器可以向量化
+    size_t length = min(actualTrajectory.getLength(), relativeTrajectory.getLength());
+    const GridCell* actual = actualTrajectory.getCells().data();
+    const GridCell* relative = relativeTrajectory.getCells().data();
+    int baseRow = finalStart.getRow() - actual[0].getRow() - relative[0].getRow();
+    int baseCol = finalStart.getCol() - actual[0].getCol() - relative[0].getCol();
+
+    Trajectory::CellList& cells = finalTrajectory.getCells();
+    cells.resize(length);
+    GridCell* out = cells.data();
+    for (size_t i = 0; i < length; i++) {
+        out[i] = GridCell(actual[i].getRow() + relative[i].getRow() + baseRow,
+                          actual[i].getCol() + relative[i].getCol() + baseCol);
+    }
+    finalTrajectory.setCurrentCell(out[length - 1]);
+}
+
+
+GridCell GameObject::sampleSeparatedStart(const GridCell& anchor, int minSeparation) {
+    // 合法区域 = 整个棋盘 - 以anchor为中心、行列距离都小于minSeparation的矩形带
+    // 先数出合法格子的总数，再用一个随机数直接定位到其中一个格子
+    const int width = MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1;
+    int rowBandLow = 0, rowBandHigh = -1, colBandLow = 0, colBandHigh = -1;
+    if (minSeparation > 0) {
+        rowBandLow = max(MIN_TRAJ_COORD, anchor.getRow() - minSeparation + 1);
+        rowBandHigh = min(MAX_TRAJ_COORD, anchor.getRow() + minSeparation - 1);
+        colBandLow = max(MIN_TRAJ_COORD, anchor.getCol() - minSeparation + 1);
+        colBandHigh = min(MAX_TRAJ_COORD, anchor.getCol() + minSeparation - 1);
+    }
+    int bandRows = max(0, rowBandHigh - rowBandLow + 1);
+    int bandCols = max(0, colBandHigh - colBandLow + 1);
+
+    int validCount = width * width - bandRows * bandCols;
+    if (validCount <= 0) {
+        throw std::invalid_argument("起点间隔过大，棋盘上没有合法的起点");
+    }
+
+    int k = rng.nextInt(validCount);
+    for (int row = MIN_TRAJ_COORD; row <= MAX_TRAJ_COORD; row++) {
+        bool inBand = row >= rowBandLow && row <= rowBandHigh;
+        int rowValid = inBand ? width - bandCols : width;
+        if (k >= rowValid) {
+            k -= rowValid;
+            continue;
+        }
+        if (!inBand) {
+            return GridCell(row, MIN_TRAJ_COORD + k);
+        }
+        // 在带内的行只能取带外的列
+        int lowCount = bandCols > 0 ? colBandLow - MIN_TRAJ_COORD : width;
+        if (k < lowCount) {
+            return GridCell(row, MIN_TRAJ_COORD + k);
+        }
+        return GridCell(row, colBandHigh + 1 + (k - lowCount));
     }
+    return anchor;
+}
+
+bool GameObject::generatePuzzle(bool isComplex, int steps) {
+    // 生成一局完整的谜题：实际轨迹、相对轨迹以及合成后的最终轨迹
+    // 先检查选项，拒绝采样在间隔不可能满足时会一直循环下去
+    validateGenerationOptions(options);
+    if (options.walkStrategy == TABLE_SAMPLED_WALK &&
+        (options.walkTable->getSteps() != steps || options.walkTable->isComplex() != isComplex)) {
+        throw std::invalid_argument("轨迹表的步数或格点类型与谜题不一致");
+    }
+    generateTrajectory(isComplex, steps);
+
+    // 相对轨迹起点至少在一个坐标轴上与实际轨迹起点相距minStartSeparation格
+    const GridCell& actualStart = actualTrajectory.getCell(0);
+    int separation = options.minStartSeparation;
+    if (options.startSampling == DIRECT_START_SAMPLING) {
+        // 直接从合法区域采样起点，每局只生成一次相对轨迹
+        generateRelativeTrajectoryFrom(sampleSeparatedStart(actualStart, separation), steps, isComplex);
+    } else {
+        // 拒绝采样：起点不满足要求就整条重新生成
+        do {
+            generateRelativeTrajectory(steps, isComplex);
+        } while ((abs(actualStart.getRow() - relativeTrajectory.getCell(0).getRow()) < separation) &&
+                 (abs(actualStart.getCol() - relativeTrajectory.getCell(0).getCol()) < separation));
+    }
+
+    calculateActualTrajectory();
+
+    // 为实际轨迹和相对轨迹建立位置索引（格子很少，只用哈希表），渲染时判断重叠为O(1)
+    // 复用同一个对象生成下一局时索引由addCell/removeLastCell增量维护，不需要重建
+    if (!actualTrajectory.hasIndex()) {
+        actualTrajectory.enableIndex();
+    }
+    if (!relativeTrajectory.hasIndex()) {
+        relativeTrajectory.enableIndex();
+    }
+
+    // 回溯失败时轨迹会短于要求的步数（最终轨迹的长度是两者中较短的一条，不需要单独检查）
+    size_t expectedLength = static_cast<size_t>(steps) + 1;
+    return actualTrajectory.getLength() == expectedLength &&
+           relativeTrajectory.getLength() == expectedLength;
 }
 
 
@@ -309,99 +409,311 @@ const Trajectory& GameObject::getActualTrajectory() const {
     return actualTrajectory;
 }
 
+
+template <class Lattice>
+static bool exceedsBounds(const GridCell& cell, int direction) {
+    return !isInsideBoard(latticeStep<Lattice>(cell, direction));
+}
+
 bool GameObject::wouldExceedBounds(const GridCell& cell, int direction, bool isSixDirection) {
-    GridCell newCell = cell;
     if (isSixDirection) {
-        switch (direction) {
-            case 0: newCell = cell + hex_directions[0]; break;
-            case 1: newCell = cell + hex_directions[1]; break;
-            case 2: newCell = cell + hex_directions[2]; break;
-            case 3: newCell = cell + hex_directions[3]; break;
-            case 4: newCell = cell + hex_directions[4]; break;
-            case 5: newCell = cell + hex_directions[5]; break;
-        }
-    } else {
-        switch (direction) {
-            case 0: newCell = cell + four_directions[0]; break;
-            case 1: newCell = cell + four_directions[1]; break;
-            case 2: newCell = cell + four_directions[2]; break;
-            case 3: newCell = cell + four_directions[3]; break;
-        }
+        return exceedsBounds<HexLattice6>(cell, direction);
     }
-    
-    return (newCell.getRow() < MIN_TRAJ_COORD || newCell.getRow() > MAX_TRAJ_COORD ||
-            newCell.getCol() < MIN_TRAJ_COORD || newCell.getCol() > MAX_TRAJ_COORD);
+    return exceedsBounds<SquareLattice4>(cell, direction);
 }
 
 bool GameObject::generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool isComplex) {
+    // 只在入口按模式分派一次，回溯循环内部不再判断模式
+    if (isComplex) {
+        return backtrackWalk<HexLattice6>(trajectory, depth, maxDepth, lastDir);
+    }
+    return backtrackWalk<SquareLattice4>(trajectory, depth, maxDepth, lastDir);
+}
+
+template <class Lattice>
+bool GameObject::backtrackWalk(Trajectory& trajectory, int depth, int maxDepth, int lastDir) {
     // 达到目标深度，轨迹生成完成
     if (depth >= maxDepth) {
         return true;
     }
-    
-    // 获取当前单元格
-    const GridCell& currentCell = trajectory.getCurrentCell();
-    
-    // 创建方向序列并随机打乱
-    vector<int> directions;
-    int numDirs = isComplex ? 6 : 4;
-    for (int i = 0; i < numDirs; i++) {
-        directions.push_back(i);
+    // 自回避轨迹最多覆盖棋盘上的全部格子，超出栈容量的深度不可能生成成功
+    if (maxDepth - depth >= MAX_BACKTRACK_FRAMES) {
+        return false;
     }
-    
-    // 简单随机化方向顺序
-    for (int i = 0; i < numDirs; i++) {
-        int j = rand() % numDirs;
-        swap(directions[i], directions[j]);
+
+    // 显式栈代替递归：每帧记录当前单元格和尚未尝试的方向，不做任何堆分配
+    BacktrackFrame frames[MAX_BACKTRACK_FRAMES];
+
+    // 占用表与轨迹同步：入栈时插入，回溯时删除
+    visitedCells.clear();
+    for (size_t i = 0; i < trajectory.getLength(); i++) {
+        visitedCells.insert(trajectory.getCells()[i]);
     }
-    
-    // 尝试每个方向
-    for (int dir : directions) {
-        // 如果这是相反方向，跳过（避免来回走）
-        if (lastDir != -1) {
-            if (isComplex && abs(dir - lastDir) == 3) continue;
-            if (!isComplex && ((dir == 0 && lastDir == 3) ||
-                               (dir == 3 && lastDir == 0) ||
-                               (dir == 1 && lastDir == 2) ||
-                               (dir == 2 && lastDir == 1))) continue;
+    int top = 0;
+    initBacktrackFrame<Lattice>(frames[0], trajectory.getCurrentCell(), lastDir, rng);
+
+    while (top >= 0) {
+        BacktrackFrame& frame = frames[top];
+
+        // 所有方向都尝试过但没有解决方案，回溯到上一帧
+        if (frame.pendingCount == 0) {
+            top--;
+            if (top >= 0) {
+                // 回溯：移除上一帧添加的单元格
+                visitedCells.erase(frame.cell);
+                trajectory.removeLastCell();
+            }
+            continue;
         }
-        
+
+        // 取出下一个待尝试的方向
+        int dir = frame.pendingDirs & 7;
+        frame.pendingDirs >>= 3;
+        frame.pendingCount--;
+
+        // 如果这是相反方向，跳过（避免来回走）
+        if (frame.lastDir != -1 && dir == Lattice::OPPOSITE[frame.lastDir]) continue;
+
         // 如果新位置超出边界，跳过
-        if (wouldExceedBounds(currentCell, dir, isComplex)) continue;
-        
+        if (exceedsBounds<Lattice>(frame.cell, dir)) continue;
+
         // 如果新位置已经在轨迹中，跳过（避免环路）
-        GridCell newCell;
-        if (isComplex) {
-            newCell = currentCell + hex_directions[dir];
-        } else {
-            newCell = currentCell + four_directions[dir];
+        if (checkIfExist<Lattice>(visitedCells, frame.cell, dir)) continue;
+
+        // 添加新单元格
+        GridCell newCell = latticeStep<Lattice>(frame.cell, dir);
+        visitedCells.insert(newCell);
+        trajectory.addCell(newCell);
+        if (depth + top + 1 >= maxDepth) {
+            return true;
         }
-        bool cellExists = false;
-        for (size_t i = 0; i < trajectory.getLength(); i++) {
-            if (trajectory.getCell(i) == newCell) {
-                cellExists = true;
+
+        // 进入下一步
+        top++;
+        initBacktrackFrame<Lattice>(frames[top], newCell, dir, rng);
+    }
+
+    return false;
+}
+
+bool GameObject::generateWalk(Trajectory& trajectory, int steps, bool isComplex) {
+    // 按生成选项选择轨迹生成算法
+    if (options.walkStrategy == PRUNED_BACKTRACK_WALK) {
+        return generateTrajectoryPruned(trajectory, steps, isComplex);
+    }
+    if (options.walkStrategy == TABLE_SAMPLED_WALK && options.walkTable &&
+        options.walkTable->getSteps() == steps && options.walkTable->isComplex() == isComplex &&
+        sampleTrajectoryFromTable(trajectory, *options.walkTable)) {
+        return true;
+    }
+    return generateTrajectoryBacktrack(trajectory, 0, steps, -1, isComplex);
+}
+
+bool GameObject::sampleTrajectoryFromTable(Trajectory& trajectory, const WalkTable& table, int maxAttempts) {
+    if (table.getWalkCount() == 0 || trajectory.getLength() == 0) {
+        return false;
+    }
+    // 拒绝采样：表中的轨迹都是以原点为起点的，平移到起点后检查是否越界
+    GridCell start = trajectory.getCurrentCell();
+    Trajectory& candidate = sampledWalk;
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+        uint64_t index = rng.nextIndex(table.getWalkCount());
+        table.decode(index, start, candidate);
+        bool inside = true;
+        for (const GridCell& cell : candidate.getCells()) {
+            if (!isInsideBoard(cell)) {
+                inside = false;
                 break;
             }
         }
-        if (cellExists) continue;
-        
-        // 添加新单元格
-        if (isComplex) {
-            removeSixDirection(trajectory, currentCell, dir);
-        } else {
-            removeFourDirection(trajectory, currentCell, dir);
+        if (inside) {
+            const Trajectory::CellList& cells = candidate.getCells();
+            for (size_t i = 1; i < cells.size(); i++) {
+                trajectory.addCell(cells[i]);
+            }
+            return true;
         }
-        
-        // 递归生成下一步
-        if (generateTrajectoryBacktrack(trajectory, depth + 1, maxDepth, dir, isComplex)) {
+    }
+    return false;
+}
+
+template <class Lattice>
+int GameObject::countFreeNeighbors(const GridCell& cell) const {
+    // 统计一个格子周围未被占用且在棋盘内的相邻格子数
+    int count = 0;
+    for (int dir = 0; dir < Lattice::DIRECTION_COUNT; dir++) {
+        GridCell neighbor = latticeStep<Lattice>(cell, dir);
+        if (isInsideBoard(neighbor) && !visitedCells.contains(neighbor)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+template <class Lattice>
+bool GameObject::touchesObstacle(const GridCell& cell, const GridCell& from) const {
+    // 落点周围（方格取8邻域，六边形取6个相邻格）除来源格外全部空闲时，
+    // 占用落点不会把空闲区域分割开，可以跳过洪水填充
+    for (int i = 0; i < Lattice::RING_SIZE; i++) {
+        GridCell neighbor(cell.getRow() + Lattice::RING_ROW[i], cell.getCol() + Lattice::RING_COL[i]);
+        if (neighbor == from) {
+            continue;
+        }
+        if (!isInsideBoard(neighbor) || visitedCells.contains(neighbor)) {
             return true;
         }
-        
-        // 回溯：移除最后添加的单元格
-        trajectory.getCells().pop_back();
     }
-    
-    // 所有方向都尝试过但没有解决方案
     return false;
 }
 
+template <class Lattice>
+int GameObject::countReachableCells(const GridCell& start, int limit) {
+    // 从start出发做洪水填充，统计可到达的空闲格子数（不含start本身）
+    // 达到limit后立即停止，因此代价不超过O(limit)
+    floodSeen.clear();
+    floodQueue.clear();
+    floodSeen.insert(start);
+    floodQueue.push_back(start);
+
+    int count = 0;
+    for (size_t head = 0; head < floodQueue.size() && count < limit; head++) {
+        GridCell cell = floodQueue[head];
+        for (int dir = 0; dir < Lattice::DIRECTION_COUNT; dir++) {
+            GridCell neighbor = latticeStep<Lattice>(cell, dir);
+            if (!isInsideBoard(neighbor) || visitedCells.contains(neighbor) || floodSeen.contains(neighbor)) {
+                continue;
+            }
+            floodSeen.insert(neighbor);
+            floodQueue.push_back(neighbor);
+            if (++count >= limit) {
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+template <class Lattice>
+void GameObject::initPrunedFrame(BacktrackFrame& frame, const GridCell& cell, int lastDir, int remaining) {
+    // 只保留可行的方向，并按落点的空闲邻居数从少到多排序（Warnsdorff规则）
+    const int numDirs = Lattice::DIRECTION_COUNT;
+
+    // 先随机打乱，相同邻居数的方向之间保持随机顺序
+    int directions[numDirs];
+    for (int i = 0; i < numDirs; i++) {
+        directions[i] = i;
+    }
+    for (int i = numDirs - 1; i > 0; i--) {
+        swap(directions[i], directions[rng.nextInt(i + 1)]);
+    }
+
+    int candidates[numDirs];
+    int degrees[numDirs];
+    int candidateCount = 0;
+    for (int i = 0; i < numDirs; i++) {
+        int dir = directions[i];
+        GridCell next = latticeStep<Lattice>(cell, dir);
+        if (!isInsideBoard(next) || visitedCells.contains(next)) {
+            continue;
+        }
+
+        int degree = countFreeNeighbors<Lattice>(next);
+        if (remaining > 1) {
+            // 落点没有出路，或落点所在的空闲区域容纳不下剩余步数，剪掉这个分支
+            if (degree == 0 ||
+                (touchesObstacle<Lattice>(next, cell) &&
+                 countReachableCells<Lattice>(next, remaining - 1) < remaining - 1)) {
+                continue;
+            }
+        }
+
+        // 插入排序（稳定），保持随机打乱后的相对顺序
+        int pos = candidateCount;
+        while (pos > 0 && degrees[pos - 1] > degree) {
+            candidates[pos] = candidates[pos - 1];
+            degrees[pos] = degrees[pos - 1];
+            pos--;
+        }
+        candidates[pos] = dir;
+        degrees[pos] = degree;
+        candidateCount++;
+    }
+
+    frame.cell = cell;
+    frame.lastDir = lastDir;
+    frame.pendingDirs = 0;
+    for (int i = candidateCount - 1; i >= 0; i--) {
+        frame.pendingDirs = (frame.pendingDirs << 3) | candidates[i];
+    }
+    frame.pendingCount = candidateCount;
+}
+
+bool GameObject::generateTrajectoryPruned(Trajectory& trajectory, int maxDepth, bool isComplex) {
+    if (isComplex) {
+        return prunedWalk<HexLattice6>(trajectory, maxDepth);
+    }
+    return prunedWalk<SquareLattice4>(trajectory, maxDepth);
+}
+
+template <class Lattice>
+bool GameObject::prunedWalk(Trajectory& trajectory, int maxDepth) {
+    // 带剪枝的回溯：优先走出路最少的方向，并提前剪掉会把自己困住的分支
+    if (maxDepth <= 0) {
+        return true;
+    }
+    if (maxDepth >= MAX_BACKTRACK_FRAMES) {
+        return false;
+    }
+
+    BacktrackFrame frames[MAX_BACKTRACK_FRAMES];
+    floodQueue.reserve(MAX_BACKTRACK_FRAMES);
+
+    visitedCells.clear();
+    for (size_t i = 0; i < trajectory.getLength(); i++) {
+        visitedCells.insert(trajectory.getCells()[i]);
+    }
+
+    // 扩展次数上限：剪枝后极少需要回溯，超出上限视为本次失败，由调用方换随机顺序重试
+    long budget = static_cast<long>(maxDepth) * 64;
+    int top = 0;
+    initPrunedFrame<Lattice>(frames[0], trajectory.getCurrentCell(), -1, maxDepth);
+
+    while (top >= 0) {
+        BacktrackFrame& frame = frames[top];
+        if (frame.pendingCount == 0) {
+            top--;
+            if (top >= 0) {
+                visitedCells.erase(frame.cell);
+                trajectory.removeLastCell();
+            }
+            continue;
+        }
+
+        int dir = frame.pendingDirs & 7;
+        frame.pendingDirs >>= 3;
+        frame.pendingCount--;
+
+        // 排序时检查过的格子可能已被更深的分支访问过，这里再确认一次
+        GridCell newCell = latticeStep<Lattice>(frame.cell, dir);
+        if (visitedCells.contains(newCell)) continue;
+        if (--budget < 0) {
+            break;
+        }
+
+        visitedCells.insert(newCell);
+        trajectory.addCell(newCell);
+        if (top + 1 >= maxDepth) {
+            return true;
+        }
+
+        top++;
+        initPrunedFrame<Lattice>(frames[top], newCell, dir, maxDepth - top);
+    }
+
+    // 超出扩展次数时撤销本次添加的所有格子，轨迹恢复为起点
+    for (; top > 0; top--) {
+        visitedCells.erase(frames[top].cell);
+        trajectory.removeLastCell();
+    }
+    return false;
+}
@@ -1,19 +1,127 @@
 #pragma once
 #include "GridCell.h"
+#include "Lattice.h"
+#include "OccupancyGrid.h"
+#include "RandomEngine.h"
+#include "RoundArena.h"
 #include "Trajectory.h"
+#include "WalkTable.h"
+#include <memory>
 #include <string>
 #include <vector>
 
+// 相对轨迹起点的采样方式
+enum StartSampling {
+    REJECTION_START_SAMPLING,   // 随机取起点，不满足间隔要求就整条轨迹重新生成
+    DIRECT_START_SAMPLING       // 直接从满足间隔要求的区域中均匀采样起点
+};
+
+// 轨迹生成算法
+enum WalkStrategy {
+    RANDOM_BACKTRACK_WALK,      // 随机方向顺序的回溯（默认，用于标准步数）
+    PRUNED_BACKTRACK_WALK,      // Warnsdorff排序 + 洪水填充剪枝，适合几百步的长轨迹
+    TABLE_SAMPLED_WALK          // 从预先枚举的轨迹表中按随机下标直接取一条（需要设置walkTable）
+};
+
+// 谜题生成选项
+struct GenerationOptions {
+    int minStartSeparation = 5;     // 两个起点至少在一个坐标轴上相距的格数
+    StartSampling startSampling = DIRECT_START_SAMPLING;
+    WalkStrategy walkStrategy = RANDOM_BACKTRACK_WALK;
+    std::shared_ptr<const WalkTable> walkTable;     // TABLE_SAMPLED_WALK使用的轨迹表，只读，可在线程间共享
+
+    bool operator==(const GenerationOptions& other) const {
+        return minStartSeparation == other.minStartSeparation && startSampling == other.startSampling &&
+               walkStrategy == other.walkStrategy && walkTable == other.walkTable;
+    }
+    bool operator!=(const GenerationOptions& other) const {
+        return !(*this == other);
+    }
+};
+
+struct BacktrackFrame;
+
 class GameObject {
 protected:
+    // 本局的内存池，下面所有轨迹和占用表都从中分配；放在第一个成员，保证最后才释放
+    // 为空时使用默认的堆分配
+    std::shared_ptr<RoundArena> arena;
     Trajectory actualTrajectory; // 对象的实际移动轨迹 
     Trajectory relativeTrajectory;  // 相对轨迹
     Trajectory predictedTrajectory;  // 玩家预测的轨迹
-    Trajectory finalTrajectory;
+    Trajectory finalTrajectory;     // 合成后的最终轨迹，生成谜题时一次算好，之后只读
+    GridCell finalStart;            // 最终轨迹的起点
+    uint64_t revision;              // 实际/相对轨迹的版本号，见getRevision()
+
+    // 实际或相对轨迹改变后换上新的版本号
+    void bumpRevision();
+
+    // 按finalStart和两条轨迹合成最终轨迹
+    void composeFinalTrajectory();
+    OccupancyGrid visitedCells;     // 生成轨迹时的占用表，复用以避免每次分配
+    OccupancyGrid floodSeen;        // 剪枝时洪水填充的访问标记
+    std::pmr::vector<GridCell> floodQueue;   // 洪水填充的队列
+    Trajectory sampledWalk;         // 从轨迹表解码出的候选轨迹
+    RandomEngine rng;               // 本对象独立的随机数引擎
+    GenerationOptions options;      // 谜题生成选项
+
+    // 按生成选项选择的算法生成steps步轨迹
+    bool generateWalk(Trajectory& trajectory, int steps, bool isComplex);
+
+    // 以格点策略（SquareLattice4 / HexLattice6）为模板参数的生成器实现
+    template <class Lattice>
+    bool backtrackWalk(Trajectory& trajectory, int depth, int maxDepth, int lastDir);
+    template <class Lattice>
+    bool prunedWalk(Trajectory& trajectory, int maxDepth);
+
+    // 剪枝辅助函数：空闲邻居数、落点是否贴着障碍、从某格出发可到达的空闲格子数（最多数到limit）
+    template <class Lattice>
+    int countFreeNeighbors(const GridCell& cell) const;
+    template <class Lattice>
+    bool touchesObstacle(const GridCell& cell, const GridCell& from) const;
+    template <class Lattice>
+    int countReachableCells(const GridCell& start, int limit);
+
+    // 初始化剪枝回溯的栈帧：过滤不可行方向并按Warnsdorff规则排序
+    template <class Lattice>
+    void initPrunedFrame(BacktrackFrame& frame, const GridCell& cell, int lastDir, int remaining);
 
 public:
     // 构造函数
     GameObject(int startRow = 0, int startCol = 0, const std::string& objectColor = "white");
+
+    // 构造函数：轨迹和占用表都从roundArena分配，对象持有内存池直到自己被销毁
+    explicit GameObject(std::shared_ptr<RoundArena> roundArena, int startRow = 0, int startCol = 0);
+
+    // 赋值会换掉内存池而成员仍留在原来的内存池中，因此禁止赋值
+    GameObject& operator=(const GameObject&) = delete;
+
+    // 本局长期对象（如玩家的预测轨迹）应使用的内存资源，没有内存池时为默认资源
+    // 与谜题共用内存池，只能在使用谜题的游戏线程中分配
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    // 局内临时缓冲区（如每次渲染的网格）应使用的内存资源，释放的块在本局内复用
+    std::pmr::memory_resource* getScratchResource() const;
+
+    // 起点间隔的上限：不超过它时，无论实际轨迹的起点在哪，棋盘上都有满足间隔要求的起点
+    static const int MAX_START_SEPARATION = (MAX_TRAJ_COORD - MIN_TRAJ_COORD) - (MAX_TRAJ_COORD - MIN_TRAJ_COORD) / 2;
+
+    // 检查生成选项能否生成谜题，不能时抛出std::invalid_argument
+    // 在启动任何生成（包括工作线程）之前调用，避免拒绝采样永远找不到合法起点
+    static void validateGenerationOptions(const GenerationOptions& generationOptions);
+
+    // 设置/获取谜题生成选项；选项无法生成谜题时抛出std::invalid_argument
+    void setGenerationOptions(const GenerationOptions& generationOptions);
+    const GenerationOptions& getGenerationOptions() const;
+
+    // 设置随机种子，相同种子生成相同的轨迹
+    void setSeed(uint64_t seedValue);
+
+    // 注入随机数引擎
+    void setRandomEngine(const RandomEngine& engine);
+
+    // 获取随机数引擎
+    RandomEngine& getRandomEngine();
     
     
     // 获取当前位置
@@ -28,22 +136,44 @@ public:
     
     // 生成相对轨迹
     void generateRelativeTrajectory(int steps, bool difficulty);
+
+    // 从指定起点生成相对轨迹
+    void generateRelativeTrajectoryFrom(const GridCell& startCell, int steps, bool difficulty);
+
+    // 在棋盘上均匀采样一个起点，使其至少在一个坐标轴上与anchor相距minSeparation格
+    // 合法区域为空时抛出std::invalid_argument
+    GridCell sampleSeparatedStart(const GridCell& anchor, int minSeparation);
     
     // 回溯法辅助函数
     bool generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool isComplex);
+
+    // 从轨迹表中采样：以轨迹当前的最后一格为起点，随机取表中的轨迹，直到取到一条完全在棋盘内的
+    // 起点固定时得到的是所有能放进棋盘的轨迹上的均匀分布；尝试maxAttempts次仍不成功时返回false
+    bool sampleTrajectoryFromTable(Trajectory& trajectory, const WalkTable& table, int maxAttempts = 256);
+
+    // 带剪枝的回溯：按空闲邻居数排序方向，并剪掉会被困在小区域里的分支
+    bool generateTrajectoryPruned(Trajectory& trajectory, int maxDepth, bool isComplex);
     
-    // 根据参考轨迹和相对轨迹计算实际轨迹
+    // 根据参考轨迹和相对轨迹计算实际轨迹：抽取起点后逐格合成
     void calculateActualTrajectory();
+
+    // 生成一局完整的谜题（实际轨迹、相对轨迹、最终轨迹），全部达到要求步数时返回true
+    // 生成选项无法生成谜题、或轨迹表的步数和格点类型与本局不一致时抛出std::invalid_argument
+    bool generatePuzzle(bool isComplex, int steps);
     
     
     // 获取实际轨迹
     const Trajectory& getActualTrajectory() const;
     
-    // 获取预测轨迹
+    // 获取预测轨迹（生成谜题时已合成，const访问不修改对象，可在多个线程中同时读取）
     const Trajectory& getfinalTrajectory() const;
     
     // 获取相对轨迹
     const Trajectory& getRelativeTrajectory() const;
+
+    // 实际/相对轨迹的版本号：在所有GameObject之间唯一，轨迹重新生成后改变
+    // 缓存由这两条轨迹算出的结果（如渲染器的静态层）时用它判断是否过期，比保存对象地址可靠
+    uint64_t getRevision() const;
     
     // 辅助函数：根据方向添加单元格
     void addCellBasedOnDirection(Trajectory& trajectory,const GridCell& cell, int direction, bool isSixDirection);
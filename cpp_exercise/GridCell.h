@@ -1,23 +1,64 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
 
+// 网格单元：行列两个32位坐标打包在一个64位整数里（行在高32位），可平凡复制，
+// 全部成员都是内联的constexpr函数；相等比较和排序都只比较这一个整数
 class GridCell {
 private:
-    int row;
-    int col;//double因为每个位置图像可能是一个正六边形
+    uint64_t bits;
+
+    static constexpr uint64_t pack(int r, int c) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(r)) << 32) | static_cast<uint32_t>(c);
+    }
 
 public:
     // 构造函数
-    GridCell(int r = 0, int c = 0);
+    constexpr GridCell(int r = 0, int c = 0) : bits(pack(r, c)) {}
 
     
     // 获取行列坐标
-    int getRow() const;
-    int getCol() const;
+    constexpr int getRow() const { return static_cast<int32_t>(static_cast<uint32_t>(bits >> 32)); }
+    constexpr int getCol() const { return static_cast<int32_t>(static_cast<uint32_t>(bits)); }
+
+    // 打包后的64位键，用于比较、排序和哈希
+    constexpr uint64_t key() const {
+        return bits;
+    }
     
     // 比较两个网格单元是否相等
-    bool operator==(const GridCell& other) const;
-    bool operator!=(const GridCell& other) const;
+    constexpr bool operator==(const GridCell& other) const { return key() == other.key(); }
+    constexpr bool operator!=(const GridCell& other) const { return key() != other.key(); }
+
+    // 按键排序（先按行的补码、再按列的补码），只用于有序容器，不代表坐标大小
+    constexpr bool operator<(const GridCell& other) const { return key() < other.key(); }
+
+    constexpr GridCell operator+(const GridCell& other)const {
+        return GridCell(getRow() + other.getRow(), getCol() + other.getCol());
+    }
+    constexpr GridCell operator-(const GridCell& other)const {
+        return GridCell(getRow() - other.getRow(), getCol() - other.getCol());
+    }
+
+    // 哈希值：对键做一次splitmix64混合，相邻格子的哈希值也分布均匀
+    constexpr uint64_t hash() const {
+        uint64_t z = key() + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
+
+static_assert(std::is_trivially_copyable<GridCell>::value, "GridCell必须可平凡复制");
+static_assert(sizeof(GridCell) == sizeof(uint64_t), "GridCell必须正好占64位");
 
-    GridCell operator+(const GridCell& other)const;
-    GridCell operator-(const GridCell& other)const;
-}; 
\ No newline at end of file
+namespace std {
+template <>
+struct hash<GridCell> {
+    size_t operator()(const GridCell& cell) const noexcept {
+        return static_cast<size_t>(cell.hash());
+    }
+};
+}
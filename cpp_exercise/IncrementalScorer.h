@@ -0,0 +1,64 @@
+#pragma once
+#include "GridCell.h"
+#include "TrajectoryView.h"
+#include <algorithm>
+#include <cstddef>
+
+// 逐步评分：绑定最终轨迹，预测轨迹每输入一格就以O(1)更新评分，结束时不需要再整体比较
+// 规则与Trajectory::calculateSimilarity相同：下标0（题目给出的起点）不计分，超出最终轨迹长度的格子也不计分
+// 绑定的是只读视图，最终轨迹在评分期间不能被修改或释放
+class IncrementalScorer {
+private:
+    TrajectoryView reference;   // 最终轨迹
+    size_t length;              // 已输入的格子数
+    size_t matches;             // 与最终轨迹重合的格子数
+    long firstDivergence;       // 第一个与最终轨迹不同的下标，-1表示至今全部重合
+    size_t streak;              // 末尾连续重合的格子数
+
+public:
+    explicit IncrementalScorer(TrajectoryView finalTrajectory)
+        : reference(finalTrajectory), length(0), matches(0), firstDivergence(-1), streak(0) {
+    }
+
+    // 输入预测轨迹的下一格
+    void addCell(const GridCell& cell) {
+        size_t index = length++;
+        if (index == 0 || index >= reference.getLength()) {
+            return;
+        }
+        if (cell == reference[index]) {
+            matches++;
+            streak++;
+        } else {
+            streak = 0;
+            if (firstDivergence < 0) {
+                firstDivergence = static_cast<long>(index);
+            }
+        }
+    }
+
+    // 清空已输入的预测，重新开始评分
+    void reset() {
+        length = 0;
+        matches = 0;
+        firstDivergence = -1;
+        streak = 0;
+    }
+
+    // 当前的相似度（重合数 / 已计分的步数），还没有计分的步时为0
+    double getSimilarity() const {
+        size_t scored = getScoredSteps();
+        return scored == 0 ? 0.0 : static_cast<double>(matches) / scored;
+    }
+
+    // 已计分的步数：下标1到min(已输入长度, 最终轨迹长度) - 1
+    size_t getScoredSteps() const {
+        size_t compared = std::min(length, reference.getLength());
+        return compared > 1 ? compared - 1 : 0;
+    }
+
+    size_t getMatchCount() const { return matches; }
+    size_t getLength() const { return length; }
+    long getFirstDivergence() const { return firstDivergence; }
+    size_t getStreak() const { return streak; }
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include "GridCell.h"
+#include <array>
+
+// 轨迹生成的坐标范围常量
+const int MIN_TRAJ_COORD = -15;
+const int MAX_TRAJ_COORD = 15;
+
+// 格子是否在轨迹生成的棋盘范围内
+inline bool isInsideBoard(const GridCell& cell) {
+    return cell.getRow() >= MIN_TRAJ_COORD && cell.getRow() <= MAX_TRAJ_COORD &&
+           cell.getCol() >= MIN_TRAJ_COORD && cell.getCol() <= MAX_TRAJ_COORD;
+}
+
+// 格点策略：把移动方向、相反方向、剪枝用的邻域环和渲染用的光晕都做成编译期常量表
+// 生成器、边界检查和渲染器以格点策略为模板参数，热循环里只剩查表，不再按模式分支
+// 新增一种格点只需要再写一个同样结构的策略类
+
+// 简单模式：四方向方格
+struct SquareLattice4 {
+    static constexpr bool IS_COMPLEX = false;
+    static constexpr int DIRECTION_COUNT = 4;
+    static constexpr int DIRECTION_BITS = 2;     // 编码一个方向需要的位数
+
+    // 方向顺序：上、右、左、下
+    static constexpr std::array<int, 4> ROW_STEP = {{-1, 0, 0, 1}};
+    static constexpr std::array<int, 4> COL_STEP = {{0, 1, -1, 0}};
+    static constexpr std::array<int, 4> OPPOSITE = {{3, 2, 1, 0}};
+
+    // 落点周围的8个格子，用于判断占用落点是否会分割空闲区域
+    static constexpr int RING_SIZE = 8;
+    static constexpr std::array<int, 8> RING_ROW = {{-1, -1, -1, 0, 1, 1, 1, 0}};
+    static constexpr std::array<int, 8> RING_COL = {{-1, 0, 1, 1, 1, 0, -1, -1}};
+
+    // 方格模式不绘制光晕
+    static constexpr int HALO_SIZE = 0;
+    static constexpr std::array<int, 0> HALO_ROW = {{}};
+    static constexpr std::array<int, 0> HALO_COL = {{}};
+};
+
+// 复杂模式：六方向（六边形）格点，每个格子在显示网格上占2行3列
+struct HexLattice6 {
+    static constexpr bool IS_COMPLEX = true;
+    static constexpr int DIRECTION_COUNT = 6;
+    static constexpr int DIRECTION_BITS = 3;
+
+    // 方向顺序：上、左上、左下、下、右下、右上
+    static constexpr std::array<int, 6> ROW_STEP = {{-2, -1, 1, 2, 1, -1}};
+    static constexpr std::array<int, 6> COL_STEP = {{0, -3, -3, 0, 3, 3}};
+    static constexpr std::array<int, 6> OPPOSITE = {{3, 4, 5, 0, 1, 2}};
+
+    // 六边形格点的相邻格本身就构成一个环
+    static constexpr int RING_SIZE = 6;
+    static constexpr std::array<int, 6> RING_ROW = ROW_STEP;
+    static constexpr std::array<int, 6> RING_COL = COL_STEP;
+
+    // 显示时围绕中心画出的六边形轮廓
+    static constexpr int HALO_SIZE = 8;
+    static constexpr std::array<int, 8> HALO_ROW = {{0, 0, -1, -1, 1, 1, -1, 1}};
+    static constexpr std::array<int, 8> HALO_COL = {{-2, 2, 1, -1, 1, -1, 0, 0}};
+};
+
+// 沿方向dir移动一步
+template <class Lattice>
+inline GridCell latticeStep(const GridCell& cell, int dir) {
+    return GridCell(cell.getRow() + Lattice::ROW_STEP[dir], cell.getCol() + Lattice::COL_STEP[dir]);
+}
+
+// 由相邻两格的位移反查方向，不是一步合法移动时返回-1
+template <class Lattice>
+inline int latticeDirectionOf(int rowDelta, int colDelta) {
+    for (int dir = 0; dir < Lattice::DIRECTION_COUNT; dir++) {
+        if (Lattice::ROW_STEP[dir] == rowDelta && Lattice::COL_STEP[dir] == colDelta) {
+            return dir;
+        }
+    }
+    return -1;
+}
+
+// 运行时只判断一次模式，之后进入对应格点的模板代码
+template <class Function>
+inline auto dispatchLattice(bool isComplex, Function&& function) -> decltype(function(SquareLattice4())) {
+    if (isComplex) {
+        return function(HexLattice6());
+    }
+    return function(SquareLattice4());
+}
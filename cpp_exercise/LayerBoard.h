@@ -0,0 +1,173 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 64位字的置位数和最低置位的下标（row不能为0）
+// GCC/Clang用内建函数（编译成popcnt/tzcnt），其他编译器（如MSVC）用可移植的实现
+inline int layerPopcount(uint64_t row) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(row);
+#else
+    row = row - ((row >> 1) & 0x5555555555555555ULL);
+    row = (row & 0x3333333333333333ULL) + ((row >> 2) & 0x3333333333333333ULL);
+    row = (row + (row >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((row * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int layerLowestBit(uint64_t row) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(row);
+#else
+    return layerPopcount((row & (0 - row)) - 1);
+#endif
+}
+
+// 显示网格上的一层位图：61x61的网格每行61列正好放进一个uint64_t（第col位表示第col列），按行优先存储
+// 实际/相对/预测轨迹各占一层，重叠分类用整行的与/或/非得到，六边形光晕用移位后按位或生成，
+// 整个网格的一次集合运算只需要61次字操作，几层的运算可以按行合并成一趟
+class LayerBoard {
+public:
+    static constexpr int SIZE = 61;     // 网格边长（行数和列数）
+
+private:
+    static constexpr uint64_t ROW_MASK = (1ULL << SIZE) - 1;   // 一行中有效的61位
+
+    uint64_t rows[SIZE];
+
+public:
+    LayerBoard() {
+        clear();
+    }
+
+    // 清空所有格子
+    void clear() {
+        for (int i = 0; i < SIZE; i++) {
+            rows[i] = 0;
+        }
+    }
+
+    // 标记网格中的一格，不在网格内时忽略
+    void set(int row, int col) {
+        if (row >= 0 && row < SIZE && col >= 0 && col < SIZE) {
+            rows[row] |= 1ULL << col;
+        }
+    }
+
+    // 网格中的一格是否被标记，不在网格内时为false
+    bool test(int row, int col) const {
+        if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+            return false;
+        }
+        return (rows[row] >> col) & 1;
+    }
+
+    // 某一行的位图
+    uint64_t getRow(int row) const {
+        return rows[row];
+    }
+
+    void setRow(int row, uint64_t bits) {
+        rows[row] = bits & ROW_MASK;
+    }
+
+    LayerBoard& operator|=(const LayerBoard& other) {
+        for (int i = 0; i < SIZE; i++) {
+            rows[i] |= other.rows[i];
+        }
+        return *this;
+    }
+
+    LayerBoard& operator&=(const LayerBoard& other) {
+        for (int i = 0; i < SIZE; i++) {
+            rows[i] &= other.rows[i];
+        }
+        return *this;
+    }
+
+    // 去掉other中标记的格子（this & ~other）
+    LayerBoard& subtract(const LayerBoard& other) {
+        for (int i = 0; i < SIZE; i++) {
+            rows[i] &= ~other.rows[i];
+        }
+        return *this;
+    }
+
+    friend LayerBoard operator|(LayerBoard left, const LayerBoard& right) {
+        return left |= right;
+    }
+
+    friend LayerBoard operator&(LayerBoard left, const LayerBoard& right) {
+        return left &= right;
+    }
+
+    // 光晕中第row行的位图：按格点策略的每个光晕偏移(dr, dc)，取第row - dr行移位dc列后按位或
+    // 方格模式没有光晕，结果为0
+    template <class Lattice>
+    uint64_t haloRow(int row) const {
+        uint64_t bits = 0;
+        for (int j = 0; j < Lattice::HALO_SIZE; j++) {
+            int source = row - Lattice::HALO_ROW[j];
+            if (source >= 0 && source < SIZE) {
+                int colDelta = Lattice::HALO_COL[j];
+                bits |= colDelta >= 0 ? rows[source] << colDelta : rows[source] >> -colDelta;
+            }
+        }
+        return bits & ROW_MASK;
+    }
+
+    // 每个格子按光晕偏移扩散出去的结果（不含格子本身，除非它也在别的格子的光晕里）
+    template <class Lattice>
+    LayerBoard halo() const {
+        LayerBoard result;
+        for (int i = 0; i < SIZE; i++) {
+            result.rows[i] = haloRow<Lattice>(i);
+        }
+        return result;
+    }
+
+    // 按行、列从小到大对每个被标记的格子调用function(row, col)
+    template <class Function>
+    void forEachCell(Function&& function) const {
+        for (int i = 0; i < SIZE; i++) {
+            uint64_t row = rows[i];
+            while (row != 0) {
+                function(i, layerLowestBit(row));
+                row &= row - 1;
+            }
+        }
+    }
+};
+
+// 一帧网格上各类重叠的格子数，与网格上的标记一一对应：
+// C为实际和相对重叠但不在预测上，M/O为预测只与实际/相对之一重叠，*为三者重叠；
+// 预测经过不止一次的格子画成P，不计入M/O/*
+struct OverlapCounts {
+    size_t actual = 0;
+    size_t relative = 0;
+    size_t predicted = 0;
+    size_t actualRelative = 0;      // C
+    size_t actualPredicted = 0;     // M
+    size_t relativePredicted = 0;   // O
+    size_t all = 0;                 // *
+};
+
+// 由三层位图和预测重复经过的格子计算重叠统计
+inline OverlapCounts countOverlaps(const LayerBoard& actual, const LayerBoard& relative,
+                                   const LayerBoard& predicted, const LayerBoard& revisited) {
+    OverlapCounts counts;
+    for (int i = 0; i < LayerBoard::SIZE; i++) {
+        uint64_t a = actual.getRow(i);
+        uint64_t r = relative.getRow(i);
+        uint64_t p = predicted.getRow(i);
+        uint64_t once = p & ~revisited.getRow(i);
+        counts.actual += static_cast<size_t>(layerPopcount(a));
+        counts.relative += static_cast<size_t>(layerPopcount(r));
+        counts.predicted += static_cast<size_t>(layerPopcount(p));
+        counts.actualRelative += static_cast<size_t>(layerPopcount(a & r & ~p));
+        counts.actualPredicted += static_cast<size_t>(layerPopcount(a & once & ~r));
+        counts.relativePredicted += static_cast<size_t>(layerPopcount(r & once & ~a));
+        counts.all += static_cast<size_t>(layerPopcount(a & r & once));
+    }
+    return counts;
+}
@@ -1,4 +1,6 @@
 #include "GameManager.h"
+#include "IncrementalScorer.h"
+#include "TrajectoryRenderer.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -17,8 +19,8 @@ using namespace std;
 
 // 函数声明
 void runMultiplayerGame(GameManager &gameManager);
-void displayTrajectories(const GameObject &objectA, const Trajectory &predictedPath, bool isComplexMode, bool showFinalTrajectory);
-Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexMode);
+void displayTrajectories(const GameObject &objectA, TrajectoryView predictedPath, bool isComplexMode, bool showFinalTrajectory);
+void inputPrediction(const GameObject &objectA, int steps, bool isComplexMode, Trajectory &prediction, IncrementalScorer &scorer);
 void savePlayerScore(const string &username, const string &mode, int score);
 void runSinglePlayerGame(GameManager &gameManager);
 void BeginGame(GameManager &gameManager, string username);
@@ -72,262 +74,33 @@ void customQuickSort(std::vector<T> &arr, Compare comp)
     }
 }
 
-// 用于控制台可视化的网格大小
-const int GRID_SIZE = 61;
-const char EMPTY_CELL = '.';
-const char ACTUAL_PATH = 'A';
-const char RELATIVE_PATH = 'R';
-const char PREDICTED_PATH = 'P';
-const char OVERLAP_AR = 'C';  // 实际和相对轨迹重叠
-const char OVERLAP_AP = 'M';  // 实际和预测轨迹重叠
-const char OVERLAP_RP = 'O';  // 相对和预测轨迹重叠
-const char OVERLAP_ALL = '*'; // 所有轨迹重叠
-const int MIN_GRID_COORD = -30;
-const int MAX_GRID_COORD = 30;
-const int MIN_TRAJ_COORD = -15;
-const int MAX_TRAJ_COORD = 15;
-
-const vector<GridCell> hex_point = {
-    GridCell(0, -2),
-    GridCell(0, 2),
-    GridCell(-1, 1),
-    GridCell(-1, -1),
-    GridCell(1, 1),
-    GridCell(1, -1),
-    GridCell(-1, 0),
-    GridCell(1, 0)};
-const vector<GridCell> four_directions = {
-    GridCell(-1, 0),
-    GridCell(0, 1),
-    GridCell(0, -1),
-    GridCell(1, 0)
-
-};
-const vector<GridCell> hex_directions = {
-    GridCell(-2, 0),
-    GridCell(-1, -3),
-    GridCell(1, -3),
-    GridCell(2, 0),
-    GridCell(1, 3),
-    GridCell(-1, 3)};
-const int UP = 0;
-const int RIGHT = 1;
-const int LEFT = 2;
-const int DOWN = 3;
-const int UP_RIGHT = 5;
-const int DOWN_RIGHT = 4;
-const int DOWN_LEFT = 2;
-const int UP_LEFT = 1;
-
 const string userInfoFile = "userInfor.txt";
 const string doublePlayerResultFile = "doublePlayerResult.txt";
 
-// 用于显示轨迹的函数
-void displayTrajectories(const GameObject &objectA, const Trajectory &predictedPath, bool isComplexMode, bool showFinalTrajectory)
-{
-    // 创建一个空的网格
-    vector<vector<string>> grid(GRID_SIZE, vector<string>(GRID_SIZE, "."));
-
-    // 获取轨迹
-    const Trajectory &actualTrajectory = objectA.getActualTrajectory();
-    const Trajectory &relativeTrajectory = objectA.getRelativeTrajectory();
-    const Trajectory &finalTrajectory = objectA.getfinalTrajectory();
-
-    // 确定网格范围 -30到30
-    const int MIN_COORD = MIN_GRID_COORD;
-    const int MAX_COORD = MAX_GRID_COORD;
-    const int OFFSET = MAX_COORD; // 用于将坐标转换为索引的偏移量
-
-    // 实际上可视化是靠一个二维vector存储得来的
-
-    // 填充网格 - 实际轨迹 (使用 A0, A1, A2, ...)
-    if (!showFinalTrajectory)
-    {
-        for (size_t i = 0; i < actualTrajectory.getLength(); i++)
-        {
-            const GridCell &cell = actualTrajectory.getCell(i);
-            int row = cell.getRow() + OFFSET;
-            int col = cell.getCol() + OFFSET;
-
-            // 确保在网格范围内
-            if (!isComplexMode)
-            {
-                if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
-                {
-                    string marker = "A" + to_string(i % 10); // 使用数字标记顺序
-                    grid[row][col] = marker;
-                }
-            }
-            else
-            {
-                if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
-                {
-                    string marker = "A" + to_string(i % 10); // 使用数字标记顺序
-                    for (int j = 0; j < 8; j++)
-                    {
-                        int gridX = row + hex_point[j].getRow();
-                        int gridY = col + hex_point[j].getCol();
-                        if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
-                        {
-                            grid[gridX][gridY] = "#";
-                        }
-                    }
-                    grid[row][col] = marker;
-                }
-            }
-        }
-    }
-
-    // 填充网格 - 相对轨迹 (使用 R0, R1, R2, ...)
-    if (!showFinalTrajectory)
-    {
-        for (size_t i = 0; i < relativeTrajectory.getLength(); i++)
-        {
-            const GridCell &cell = relativeTrajectory.getCell(i);
-            int row = cell.getRow() + OFFSET;
-            int col = cell.getCol() + OFFSET;
-
-            // 确保在网格范围内
-            if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
-            {
-                string marker = "R" + to_string(i % 10);
-                // 如果已经有标记，表示重叠
-                if (grid[row][col] != "." && grid[row][col] != "+")
-                {
-                    if (grid[row][col][0] == 'A')
-                    {
-                        marker = "C" + to_string(i % 10); // A和R重叠
-                    }
-                    else if (grid[row][col][0] == 'P')
-                    {
-                        marker = "O" + to_string(i % 10); // R和P重叠
-                    }
-                    else if (grid[row][col][0] == 'C')
-                    {
-                        marker = "*" + to_string(i % 10); // 全部重叠
-                    }
-                }
-
-                if (isComplexMode)
-                {
-                    for (int j = 0; j < 8; j++)
-                    {
-                        int gridX = row + hex_point[j].getRow();
-                        int gridY = col + hex_point[j].getCol();
-                        if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
-                        {
-                            grid[gridX][gridY] = "&";
-                        }
-                    }
-                }
-                grid[row][col] = marker;
-            }
-        }
-    }
+// 整个程序复用一个渲染器，帧缓冲区只分配一次，每帧一次写出；终端足够大时只重画变化的格子
+static TrajectoryRenderer trajectoryRenderer;
 
-    // 填充网格 - 预测轨迹 (使用 P0, P1, P2, ...)
-    for (size_t i = 0; i < predictedPath.getLength(); i++)
-    {
-        const GridCell &cell = predictedPath.getCell(i);
-        // 添加安全检查，确保i不超过finalTrajectory的长度
-        bool canCompareWithWishCell = (i < finalTrajectory.getLength());
-        int row = cell.getRow() + OFFSET;
-        int col = cell.getCol() + OFFSET;
-
-        // 确保在网格范围内
-        if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
-        {
-            string marker = "P" + to_string(i % 10);
-            // 处理重叠情况
-            if (grid[row][col] != ".")
-            {
-                if (grid[row][col][0] == 'A')
-                {
-                    marker = "M" + to_string(i % 10); // A和P重叠
-                }
-                else if (grid[row][col][0] == 'R')
-                {
-                    marker = "O" + to_string(i % 10); // R和P重叠
-                }
-                else if (grid[row][col][0] == 'C')
-                {
-                    marker = "*" + to_string(i % 10); // 全部重叠
-                }
-            }
-
-            if (isComplexMode)
-            {
-                for (int j = 0; j < 8; j++)
-                {
-                    int gridX = row + hex_point[j].getRow();
-                    int gridY = col + hex_point[j].getCol();
-                    if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
-                    {
-                        grid[gridX][gridY] = "&";
-                    }
-                }
-            }
-            grid[row][col] = marker;
-        }
-    }
-
-    if (showFinalTrajectory)
-    {
-        cout << endl;
-    }
-    else
-    {
-        std::cout << "A0-A9 - 参考轨迹，R0-R9 - 相对轨迹，P0-P9 - 预测轨迹" << endl;
-        std::cout << "C - 参考和相对重叠，M - 参考和预测重叠，O - 相对和预测重叠，* - 全部重叠" << endl;
-    }
-
-    std::cout << "数字表示轨迹中点的顺序 (0-9循环)" << endl;
-
-    // 打印坐标轴标签
-    std::cout << "\n坐标范围：X轴和Y轴从 " << MIN_COORD << " 到 " << MAX_COORD << endl;
-
-    // 打印网格内容 - 修正行标签对齐
-    for (int i = 0; i < GRID_SIZE; i++)
-    {
-        if (i % 5 == 0)
-        {
-            int originalCoord = MIN_GRID_COORD + (i);
-            cout << setw(5) << originalCoord << " "; // 统一使用5个字符宽度
-        }
-        else
-        {
-            cout << "      "; // 保持6个字符的空间
-        }
-
-        for (int j = 0; j < GRID_SIZE; j++)
-        {
-            cout << setw(2) << grid[i][j] << " ";
-        }
-        cout << endl;
-    }
-
-    // 显示系统生成的完整实际轨迹（用于测试）
-    cout << "\n系统生成的实际轨迹（通过计算得到）：" << endl;
-    for (size_t i = 0; i < finalTrajectory.getLength(); i++)
-    {
-        const GridCell &cell = finalTrajectory.getCell(i);
-        cout << "  点" << i << ": 原始坐标("
-             << cell.getRow() << "," << cell.getCol() << ")" << endl;
-    }
+// 用于显示轨迹的函数（六边形格点会在每个点周围画出光晕）
+void displayTrajectories(const GameObject &objectA, TrajectoryView predictedPath, bool isComplexMode, bool showFinalTrajectory)
+{
+    trajectoryRenderer.render(objectA, predictedPath, isComplexMode, showFinalTrajectory);
 }
 
-// 手动输入预测轨迹
-Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexMode)
+// 手动输入预测轨迹，每输入一格同时交给scorer逐步评分
+void inputPrediction(const GameObject &objectA, int steps, bool isComplexMode, Trajectory &prediction, IncrementalScorer &scorer)
 {
-    Trajectory prediction;
-    const Trajectory &finalTrajectory = objectA.getfinalTrajectory();
+    prediction.clear();
+    scorer.reset();
+    prediction.enableIndex(MIN_GRID_COORD, MAX_GRID_COORD);
+    TrajectoryView finalTrajectory = objectA.getfinalTrajectory();
     int finalLength = finalTrajectory.getLength();
 
     std::cout << "请输入预测轨迹（" << steps << "步）" << std::endl;
 
     // 预测轨迹的起始点要求和电脑通过actualTrajectory和
     // RelativeTrajectory计算得出的finalTrajectory的起始点一致。
-    prediction.addCell(finalTrajectory.getCell(0));
+    prediction.addCell(finalTrajectory.front());
+    scorer.addCell(finalTrajectory.front());
     cout << "起始点行坐标（相对于中心0）：" << prediction.getCurrentCell().getRow() << endl;
     cout << "起始点列坐标（相对于中心0）：" << prediction.getCurrentCell().getCol() << endl;
 
@@ -344,7 +117,7 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
             cout << "\n已输入的预测坐标:" << endl;
             for (size_t j = 1; j < prediction.getLength(); j++)
             { // 从索引1开始，跳过起始点
-                const GridCell &cell = prediction.getCell(j);
+                const GridCell &cell = prediction[j];
                 cout << "  步骤 " << j << ": (" << cell.getRow() << ", " << cell.getCol() << ")" << endl;
             }
         }
@@ -367,6 +140,7 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
 
         GridCell newCell(x, y);
         prediction.addCell(newCell);
+        scorer.addCell(newCell);
     }
     displayTrajectories(objectA, prediction, isComplexMode, false);
 
@@ -374,11 +148,12 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
     cout << "\n完整的预测轨迹坐标:" << endl;
     for (size_t i = 0; i < prediction.getLength(); i++)
     {
-        const GridCell &cell = prediction.getCell(i);
+        const GridCell &cell = prediction[i];
         cout << "  点 " << i << ": (" << cell.getRow() << ", " << cell.getCol() << ")" << endl;
     }
 
-    return prediction;
+    // 输入结束，释放固定在屏幕顶部的画面，之后的输出和清屏恢复正常
+    trajectoryRenderer.getScreen().release();
 }
 
 // 保存玩家得分到文件
@@ -430,21 +205,23 @@ void runSinglePlayerGame(GameManager &gameManager)
 {
     bool isComplexMode = gameManager.isComplexMode();
     bool isTimeBasedMode = gameManager.isTimeBasedGame();
-    // 获取游戏对象
-    const GameObject &objectA = gameManager.getObjectA();
+    // 获取游戏对象：持有谜题直到本局结束，预测轨迹使用的内存池也随之保留
+    shared_ptr<const GameObject> puzzle = gameManager.getSharedPuzzle();
+    const GameObject &objectA = *puzzle;
 
     // 显示初始轨迹
-    Trajectory emptyPrediction; // 创建一个空的预测轨迹用于初始显示
     cout << "\n初始轨迹：" << endl;
     cout << "A - 参考轨迹(蓝色物体的运动)" << endl;
     cout << "R - 相对轨迹(红色物体相对于蓝色物体的运动)" << endl;
     cout << "\n请预测红色物体在实际坐标系中的运动轨迹" << endl;
 
     int predictionSteps = 10;
-    Trajectory userPrediction = inputPrediction(objectA, predictionSteps, isComplexMode);
+    Trajectory userPrediction(objectA.getMemoryResource());
+    IncrementalScorer scorer(objectA.getfinalTrajectory());
+    inputPrediction(objectA, predictionSteps, isComplexMode, userPrediction, scorer);
 
-    // 输出评分
-    double similarity = userPrediction.calculateSimilarity(objectA.getfinalTrajectory());
+    // 输出评分：输入过程中已经逐步算好，不再整体比较
+    double similarity = scorer.getSimilarity();
     cout << "相似度: " << similarity * 100 << "%" << endl;
     int score = similarity * 1000;
     gameManager.getCurrentPlayer().addScore(score);
@@ -710,7 +487,6 @@ void BeginGame(GameManager &gameManager, string username)
 
 int main()
 {
-    srand(static_cast<unsigned int>(time(0)));
 #if defined(_WIN32)
     // 切换控制台到 UTF-8
     SetConsoleOutputCP(CP_UTF8);
@@ -910,7 +686,6 @@ void runMultiplayerGame(GameManager &gameManager)
         cout << "当前玩家: " << gameManager.getCurrentPlayer().getName() << endl;
 
         // 生成游戏数据
-        srand(static_cast<unsigned int>(time(nullptr) + gameManager.getCurrentRound()));
         gameManager.generateGameData();
 
         // 开始计时
@@ -0,0 +1,104 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+using namespace std;
+
+// 分块边长为8，一个块正好对应一个64位掩码
+static uint64_t tileKeyOf(const GridCell& cell) {
+    // 算术右移即向下取整，负坐标也能正确分块
+    uint32_t tileRow = static_cast<uint32_t>(cell.getRow() >> 3);
+    uint32_t tileCol = static_cast<uint32_t>(cell.getCol() >> 3);
+    return (static_cast<uint64_t>(tileRow) << 32) | tileCol;
+}
+
+static uint64_t tileBitOf(const GridCell& cell) {
+    return 1ULL << (((cell.getRow() & 7) << 3) | (cell.getCol() & 7));
+}
+
+static size_t hashTileKey(uint64_t key) {
+    // splitmix64的混合函数
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+OccupancyGrid::OccupancyGrid(int minCoord, int maxCoord, pmr::memory_resource* resource)
+    : minCoord(minCoord), width(0), bits(resource), tileKeys(resource), tileMasks(resource), tileCount(0) {
+    if (maxCoord >= minCoord) {
+        width = maxCoord - minCoord + 1;
+        bits.assign((static_cast<size_t>(width) * width + 63) / 64, 0);
+    }
+}
+
+OccupancyGrid OccupancyGrid::unbounded() {
+    // maxCoord < minCoord表示没有位图部分
+    return OccupancyGrid(0, -1);
+}
+
+void OccupancyGrid::clear() {
+    fill(bits.begin(), bits.end(), 0);
+    fill(tileKeys.begin(), tileKeys.end(), EMPTY_TILE);
+    fill(tileMasks.begin(), tileMasks.end(), 0);
+    tileCount = 0;
+}
+
+size_t OccupancyGrid::findTile(uint64_t key) const {
+    // 线性探测，返回key所在槽位或第一个空槽位
+    size_t mask = tileKeys.size() - 1;
+    size_t slot = hashTileKey(key) & mask;
+    while (tileKeys[slot] != key && tileKeys[slot] != EMPTY_TILE) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void OccupancyGrid::growTiles() {
+    // 负载因子超过1/2时容量翻倍并重新插入
+    pmr::vector<uint64_t> oldKeys(tileKeys.get_allocator());
+    pmr::vector<uint64_t> oldMasks(tileMasks.get_allocator());
+    oldKeys.swap(tileKeys);
+    oldMasks.swap(tileMasks);
+
+    size_t capacity = oldKeys.empty() ? 64 : oldKeys.size() * 2;
+    tileKeys.assign(capacity, EMPTY_TILE);
+    tileMasks.assign(capacity, 0);
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldKeys[i] != EMPTY_TILE) {
+            size_t slot = findTile(oldKeys[i]);
+            tileKeys[slot] = oldKeys[i];
+            tileMasks[slot] = oldMasks[i];
+        }
+    }
+}
+
+bool OccupancyGrid::containsHashed(const GridCell& cell) const {
+    if (tileCount == 0) {
+        return false;
+    }
+    size_t slot = findTile(tileKeyOf(cell));
+    return (tileMasks[slot] & tileBitOf(cell)) != 0;
+}
+
+void OccupancyGrid::insertHashed(const GridCell& cell) {
+    if ((tileCount + 1) * 2 > tileKeys.size()) {
+        growTiles();
+    }
+    uint64_t key = tileKeyOf(cell);
+    size_t slot = findTile(key);
+    if (tileKeys[slot] == EMPTY_TILE) {
+        tileKeys[slot] = key;
+        tileCount++;
+    }
+    tileMasks[slot] |= tileBitOf(cell);
+}
+
+void OccupancyGrid::eraseHashed(const GridCell& cell) {
+    // 只清除占用位，分块本身保留，避免开放寻址表的删除开销
+    if (tileCount == 0) {
+        return;
+    }
+    size_t slot = findTile(tileKeyOf(cell));
+    tileMasks[slot] &= ~tileBitOf(cell);
+}
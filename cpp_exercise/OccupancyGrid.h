@@ -0,0 +1,77 @@
+#pragma once
+#include "GridCell.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 棋盘占用表：判断某个格子是否已被轨迹占用，插入/删除/查询均为O(1)
+// 有界棋盘使用位图；超出边界的格子（或无界棋盘）退回到按8x8分块的哈希表
+class OccupancyGrid {
+private:
+    int minCoord;                 // 位图覆盖的最小坐标
+    int width;                    // 位图边长，0表示无界棋盘（全部走哈希表）
+    std::pmr::vector<uint64_t> bits;   // 位图，按行优先存储
+
+    // 哈希回退：开放寻址表，key为分块坐标，mask为块内64个格子的占用位
+    std::pmr::vector<uint64_t> tileKeys;
+    std::pmr::vector<uint64_t> tileMasks;
+    size_t tileCount;
+
+    static constexpr uint64_t EMPTY_TILE = 0x8000000080000000ULL;
+
+    // 位图中的位置，不在位图范围内返回-1
+    long bitIndex(const GridCell& cell) const {
+        int r = cell.getRow() - minCoord;
+        int c = cell.getCol() - minCoord;
+        if (width == 0 || r < 0 || r >= width || c < 0 || c >= width) {
+            return -1;
+        }
+        return static_cast<long>(r) * width + c;
+    }
+
+    size_t findTile(uint64_t key) const;
+    void growTiles();
+    bool containsHashed(const GridCell& cell) const;
+    void insertHashed(const GridCell& cell);
+    void eraseHashed(const GridCell& cell);
+
+public:
+    // 构造函数：位图覆盖[minCoord, maxCoord]范围内的正方形棋盘，位图和哈希表从resource分配
+    OccupancyGrid(int minCoord, int maxCoord, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // 创建无界棋盘的占用表
+    static OccupancyGrid unbounded();
+
+    // 查询格子是否被占用
+    bool contains(const GridCell& cell) const {
+        long index = bitIndex(cell);
+        if (index < 0) {
+            return containsHashed(cell);
+        }
+        return (bits[index >> 6] >> (index & 63)) & 1;
+    }
+
+    // 标记格子为占用
+    void insert(const GridCell& cell) {
+        long index = bitIndex(cell);
+        if (index < 0) {
+            insertHashed(cell);
+            return;
+        }
+        bits[index >> 6] |= 1ULL << (index & 63);
+    }
+
+    // 取消格子的占用标记
+    void erase(const GridCell& cell) {
+        long index = bitIndex(cell);
+        if (index < 0) {
+            eraseHashed(cell);
+            return;
+        }
+        bits[index >> 6] &= ~(1ULL << (index & 63));
+    }
+
+    // 清空所有占用标记（保留已分配的空间）
+    void clear();
+};
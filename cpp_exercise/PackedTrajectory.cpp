@@ -0,0 +1,229 @@
+#include "PackedTrajectory.h"
+#include "Lattice.h"
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+using namespace std;
+
+// 变长整数（每字节7位，最高位表示后面还有字节），有符号数先做zigzag变换
+static void writeVarint(ostream& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+static uint64_t readVarint(istream& in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) {
+            throw runtime_error("紧凑轨迹数据不完整");
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw runtime_error("紧凑轨迹数据格式错误");
+}
+
+static uint64_t zigzag(int value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+static int unzigzag(uint64_t value) {
+    return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+}
+
+// 按格点展开：从cell出发走完[first, last)步，每走一步调用一次visit
+template <class Lattice, class Visit>
+static GridCell walkCodes(const vector<uint64_t>& codes, GridCell cell, size_t first, size_t last, Visit visit) {
+    const int bits = Lattice::DIRECTION_BITS;
+    const uint64_t mask = (1u << bits) - 1;
+    for (size_t step = first; step < last; step++) {
+        size_t bit = step * bits;
+        size_t word = bit >> 6;
+        int offset = static_cast<int>(bit & 63);
+        uint64_t code = codes[word] >> offset;
+        if (offset + bits > 64) {
+            code |= codes[word + 1] << (64 - offset);
+        }
+        cell = latticeStep<Lattice>(cell, static_cast<int>(code & mask));
+        visit(cell);
+    }
+    return cell;
+}
+
+PackedTrajectory::PackedTrajectory() : start(0, 0), stepCount(0), complex(false) {
+}
+
+int PackedTrajectory::bitsPerStep() const {
+    return complex ? HexLattice6::DIRECTION_BITS : SquareLattice4::DIRECTION_BITS;
+}
+
+void PackedTrajectory::appendDirection(int dir) {
+    size_t bit = stepCount * bitsPerStep();
+    size_t word = bit >> 6;
+    int offset = static_cast<int>(bit & 63);
+    if (word + 1 >= codes.size()) {
+        codes.resize(word + 2, 0);
+    }
+    codes[word] |= static_cast<uint64_t>(dir) << offset;
+    if (offset + bitsPerStep() > 64) {
+        codes[word + 1] |= static_cast<uint64_t>(dir) >> (64 - offset);
+    }
+    stepCount++;
+}
+
+void PackedTrajectory::rebuildCheckpoints() {
+    // 去掉末尾多余的空字，再从头展开一遍记录检查点
+    codes.resize((stepCount * bitsPerStep() + 63) / 64 + 1, 0);
+    checkpoints.clear();
+    checkpoints.reserve(stepCount / CHECKPOINT_INTERVAL + 1);
+    checkpoints.push_back(start);
+    size_t index = 0;
+    dispatchLattice(complex, [&](auto lattice) {
+        walkCodes<decltype(lattice)>(codes, start, 0, stepCount, [&](const GridCell& cell) {
+            index++;
+            if (index % CHECKPOINT_INTERVAL == 0) {
+                checkpoints.push_back(cell);
+            }
+        });
+    });
+}
+
+PackedTrajectory PackedTrajectory::pack(const Trajectory& trajectory, bool isComplex) {
+    const Trajectory::CellList& cells = trajectory.getCells();
+    if (cells.empty()) {
+        throw invalid_argument("不能压缩空轨迹");
+    }
+    PackedTrajectory packed;
+    packed.start = cells[0];
+    packed.complex = isComplex;
+    packed.codes.reserve((cells.size() * packed.bitsPerStep() + 63) / 64 + 1);
+    for (size_t i = 1; i < cells.size(); i++) {
+        int dr = cells[i].getRow() - cells[i - 1].getRow();
+        int dc = cells[i].getCol() - cells[i - 1].getCol();
+        int dir = isComplex ? latticeDirectionOf<HexLattice6>(dr, dc) : latticeDirectionOf<SquareLattice4>(dr, dc);
+        if (dir < 0) {
+            throw invalid_argument("轨迹中相邻两格不是格点上的一步");
+        }
+        packed.appendDirection(dir);
+    }
+    packed.rebuildCheckpoints();
+    return packed;
+}
+
+Trajectory PackedTrajectory::unpack() const {
+    Trajectory trajectory;
+    unpackInto(trajectory);
+    return trajectory;
+}
+
+void PackedTrajectory::unpackInto(Trajectory& trajectory) const {
+    trajectory.clear();
+    if (checkpoints.empty()) {
+        return;
+    }
+    trajectory.reserve(stepCount + 1);
+    trajectory.addCell(start);
+    dispatchLattice(complex, [&](auto lattice) {
+        walkCodes<decltype(lattice)>(codes, start, 0, stepCount, [&trajectory](const GridCell& cell) {
+            trajectory.addCell(cell);
+        });
+    });
+}
+
+size_t PackedTrajectory::getLength() const {
+    return checkpoints.empty() ? 0 : stepCount + 1;
+}
+
+bool PackedTrajectory::isComplex() const {
+    return complex;
+}
+
+int PackedTrajectory::getDirection(size_t step) const {
+    if (step >= stepCount) {
+        throw out_of_range("Index out of range");
+    }
+    int bits = bitsPerStep();
+    size_t bit = step * bits;
+    int offset = static_cast<int>(bit & 63);
+    uint64_t code = codes[bit >> 6] >> offset;
+    if (offset + bits > 64) {
+        code |= codes[(bit >> 6) + 1] << (64 - offset);
+    }
+    return static_cast<int>(code & ((1u << bits) - 1));
+}
+
+GridCell PackedTrajectory::getCell(size_t index) const {
+    if (index >= getLength()) {
+        throw out_of_range("Index out of range");
+    }
+    // 从最近的检查点往后展开
+    size_t checkpoint = index / CHECKPOINT_INTERVAL;
+    size_t first = checkpoint * CHECKPOINT_INTERVAL;
+    return dispatchLattice(complex, [&](auto lattice) {
+        return walkCodes<decltype(lattice)>(codes, checkpoints[checkpoint], first, index, [](const GridCell&) {});
+    });
+}
+
+size_t PackedTrajectory::getPackedBytes() const {
+    return codes.size() * sizeof(uint64_t) + checkpoints.size() * sizeof(GridCell);
+}
+
+void PackedTrajectory::write(ostream& out) const {
+    // 格式：格点类型 | 起点行 | 起点列 | 步数 | 方向编号（按位紧排，向上取整到字节）
+    out.put(complex ? 1 : 0);
+    writeVarint(out, zigzag(start.getRow()));
+    writeVarint(out, zigzag(start.getCol()));
+    writeVarint(out, getLength());
+    size_t byteCount = (stepCount * bitsPerStep() + 7) / 8;
+    for (size_t i = 0; i < byteCount; i++) {
+        out.put(static_cast<char>(codes[i / 8] >> (8 * (i % 8))));
+    }
+}
+
+PackedTrajectory PackedTrajectory::read(istream& in) {
+    int type = in.get();
+    if (type != 0 && type != 1) {
+        throw runtime_error("紧凑轨迹数据格式错误");
+    }
+    PackedTrajectory packed;
+    packed.complex = type == 1;
+    int row = unzigzag(readVarint(in));
+    int col = unzigzag(readVarint(in));
+    packed.start = GridCell(row, col);
+    uint64_t length = readVarint(in);
+    if (length == 0) {
+        return packed;
+    }
+    // 长度来自数据本身，先限制范围，保证后面按位计算不会溢出
+    if (length - 1 > MAX_READ_STEPS) {
+        throw runtime_error("紧凑轨迹数据格式错误");
+    }
+    packed.stepCount = static_cast<size_t>(length - 1);
+    size_t byteCount = (packed.stepCount * packed.bitsPerStep() + 7) / 8;
+    // 边读边扩容，而不是按声明的长度一次分配：截断或伪造长度的数据在读到结尾时就失败，不会先占用大块内存
+    for (size_t i = 0; i < byteCount; i++) {
+        int byte = in.get();
+        if (byte == EOF) {
+            throw runtime_error("紧凑轨迹数据不完整");
+        }
+        if (i / 8 >= packed.codes.size()) {
+            packed.codes.push_back(0);
+        }
+        packed.codes[i / 8] |= static_cast<uint64_t>(byte) << (8 * (i % 8));
+    }
+    // 六边形每步3位，可以编码出不存在的方向6、7，展开前逐步检查
+    int directionCount = packed.complex ? HexLattice6::DIRECTION_COUNT : SquareLattice4::DIRECTION_COUNT;
+    for (size_t step = 0; step < packed.stepCount; step++) {
+        if (packed.getDirection(step) >= directionCount) {
+            throw runtime_error("紧凑轨迹数据格式错误：方向超出格点的方向数");
+        }
+    }
+    packed.rebuildCheckpoints();
+    return packed;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GridCell.h"
+#include "Trajectory.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// 紧凑轨迹：只保存起点和每一步的方向编号（方格每步2位，六边形每步3位）
+// 每CHECKPOINT_INTERVAL步记录一个检查点，随机访问第i个格子最多只需展开CHECKPOINT_INTERVAL-1步
+// 写入文件时起点和步数用变长整数，方向按位紧排，十步的方格轨迹只占7个字节
+class PackedTrajectory {
+private:
+    GridCell start;                     // 起点
+    size_t stepCount;                   // 步数（格子数 - 1）
+    bool complex;                       // 是否为六边形格点
+    std::vector<uint64_t> codes;        // 按位紧排的方向编号，第k步位于第 k*每步位数 位
+    std::vector<GridCell> checkpoints;  // 第 k*CHECKPOINT_INTERVAL 个格子
+
+    int bitsPerStep() const;
+    void appendDirection(int dir);
+    void rebuildCheckpoints();
+
+public:
+    static const size_t CHECKPOINT_INTERVAL = 64;
+
+    // read()接受的最大步数，超过时视为数据格式错误
+    static const uint64_t MAX_READ_STEPS = uint64_t(1) << 32;
+
+    // 构造函数：空轨迹
+    PackedTrajectory();
+
+    // 压缩一条轨迹；轨迹为空，或相邻两格不是isComplex格点上的一步时抛出std::invalid_argument
+    static PackedTrajectory pack(const Trajectory& trajectory, bool isComplex);
+
+    // 展开成Trajectory
+    Trajectory unpack() const;
+
+    // 展开到已有的Trajectory中（覆盖原有内容，可复用其容量）
+    void unpackInto(Trajectory& trajectory) const;
+
+    // 获取格子数量
+    size_t getLength() const;
+
+    // 是否为六边形格点
+    bool isComplex() const;
+
+    // 获取第step步的方向编号
+    int getDirection(size_t step) const;
+
+    // 获取第index个格子（越界时抛出std::out_of_range）
+    GridCell getCell(size_t index) const;
+
+    // 压缩后的内存占用（字节，不含对象本身）
+    size_t getPackedBytes() const;
+
+    // 写入/读取二进制流；读取失败、数据不完整、步数超过MAX_READ_STEPS或方向编号不存在时抛出std::runtime_error
+    void write(std::ostream& out) const;
+    static PackedTrajectory read(std::istream& in);
+};
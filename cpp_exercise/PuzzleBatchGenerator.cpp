@@ -0,0 +1,129 @@
+#include "PuzzleBatchGenerator.h"
+#include "RandomEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+using namespace std;
+
+// 单局谜题最多尝试的种子数，超过后认为参数无法生成谜题
+const int MAX_PUZZLE_ATTEMPTS = 16;
+
+PuzzleBatchGenerator::PuzzleBatchGenerator(bool isComplex, int steps, unsigned int threadCount)
+    : isComplex(isComplex), steps(steps), threadCount(threadCount), puzzleCount(0) {
+    if (this->threadCount == 0) {
+        this->threadCount = max(1u, thread::hardware_concurrency());
+    }
+}
+
+void PuzzleBatchGenerator::generate(size_t count, uint64_t baseSeed) {
+    // 启动线程前检查选项，工作线程中不应出现可预知的参数错误
+    GameObject::validateGenerationOptions(options);
+
+    // 一次性分配全部输出空间，工作线程只写入各自负责的区段
+    puzzleCount = count;
+    cells.assign(count * 3 * getTrajectoryLength(), GridCell());
+
+    atomic<size_t> nextIndex(0);
+    atomic<bool> failed(false);
+    size_t workerCount = min<size_t>(threadCount, (count + PUZZLES_PER_CLAIM - 1) / PUZZLES_PER_CLAIM);
+
+    // 每个工作线程一个异常槽位，异常不能离开线程函数，否则会直接终止进程
+    vector<exception_ptr> errors(workerCount);
+    vector<thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&PuzzleBatchGenerator::runWorker, this, count, baseSeed, ref(nextIndex), ref(failed),
+                             ref(errors[i]));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    if (failed.load()) {
+        puzzleCount = 0;
+        cells.clear();
+        for (const exception_ptr& error : errors) {
+            if (error) {
+                rethrow_exception(error);
+            }
+        }
+        throw runtime_error("无法按要求的步数生成谜题");
+    }
+}
+
+void PuzzleBatchGenerator::runWorker(size_t count, uint64_t baseSeed, atomic<size_t>& nextIndex, atomic<bool>& failed,
+                                     exception_ptr& error) {
+    try {
+        generateClaims(count, baseSeed, nextIndex, failed);
+    } catch (...) {
+        error = current_exception();
+        failed.store(true);
+    }
+}
+
+void PuzzleBatchGenerator::generateClaims(size_t count, uint64_t baseSeed, atomic<size_t>& nextIndex,
+                                          atomic<bool>& failed) {
+    // 每个工作线程拥有自己的GameObject，即独立的随机数引擎和临时缓冲区
+    GameObject worker;
+    worker.setGenerationOptions(options);
+    size_t length = getTrajectoryLength();
+    while (!failed.load(memory_order_relaxed)) {
+        size_t begin = nextIndex.fetch_add(PUZZLES_PER_CLAIM);
+        if (begin >= count) {
+            return;
+        }
+        size_t end = min(count, begin + PUZZLES_PER_CLAIM);
+        for (size_t index = begin; index < end; index++) {
+            // 生成失败时换一个同样由序号决定的种子重试，保证结果可复现
+            bool success = false;
+            for (int attempt = 0; attempt < MAX_PUZZLE_ATTEMPTS && !success; attempt++) {
+                worker.setSeed(RandomEngine::deriveSeed(baseSeed, index + attempt * count));
+                success = worker.generatePuzzle(isComplex, steps);
+            }
+            if (!success) {
+                failed.store(true);
+                return;
+            }
+
+            GridCell* out = &cells[index * 3 * length];
+            copy_n(worker.getActualTrajectory().getCells().begin(), length, out);
+            copy_n(worker.getRelativeTrajectory().getCells().begin(), length, out + length);
+            copy_n(worker.getfinalTrajectory().getCells().begin(), length, out + 2 * length);
+        }
+    }
+}
+
+void PuzzleBatchGenerator::setGenerationOptions(const GenerationOptions& generationOptions) {
+    GameObject::validateGenerationOptions(generationOptions);
+    options = generationOptions;
+}
+
+size_t PuzzleBatchGenerator::getPuzzleCount() const {
+    return puzzleCount;
+}
+
+size_t PuzzleBatchGenerator::getTrajectoryLength() const {
+    return static_cast<size_t>(steps) + 1;
+}
+
+const GridCell* PuzzleBatchGenerator::getActualCells(size_t index) const {
+    return &cells[index * 3 * getTrajectoryLength()];
+}
+
+const GridCell* PuzzleBatchGenerator::getRelativeCells(size_t index) const {
+    return getActualCells(index) + getTrajectoryLength();
+}
+
+const GridCell* PuzzleBatchGenerator::getFinalCells(size_t index) const {
+    return getActualCells(index) + 2 * getTrajectoryLength();
+}
+
+const std::vector<GridCell>& PuzzleBatchGenerator::getCells() const {
+    return cells;
+}
+
+unsigned int PuzzleBatchGenerator::getThreadCount() const {
+    return threadCount;
+}
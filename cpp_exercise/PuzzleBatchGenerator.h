@@ -0,0 +1,61 @@
+#pragma once
+#include "GameObject.h"
+#include "GridCell.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+// 批量谜题生成器：在多个工作线程上并行生成N局谜题
+// 每局谜题与GameManager::generateGameData生成的内容相同（实际轨迹、相对轨迹、最终轨迹）
+// 所有结果按谜题顺序写入同一块连续缓冲区：
+//   谜题i = [实际轨迹 steps+1 格][相对轨迹 steps+1 格][最终轨迹 steps+1 格]
+class PuzzleBatchGenerator {
+private:
+    bool isComplex;                 // 是否为复杂（六方向）模式
+    int steps;                      // 每条轨迹的步数
+    unsigned int threadCount;       // 工作线程数
+    GenerationOptions options;      // 谜题生成选项
+    size_t puzzleCount;             // 已生成的谜题数量
+    std::vector<GridCell> cells;    // 连续输出缓冲区
+
+    // 不断领取一段谜题序号并生成，是工作线程的主体
+    void generateClaims(size_t count, uint64_t baseSeed, std::atomic<size_t>& nextIndex, std::atomic<bool>& failed);
+
+    // 单个工作线程的入口：生成中抛出的异常记录到error，由generate()在游戏线程中重新抛出
+    void runWorker(size_t count, uint64_t baseSeed, std::atomic<size_t>& nextIndex, std::atomic<bool>& failed,
+                   std::exception_ptr& error);
+
+public:
+    // 每个工作线程一次领取的谜题数量
+    static constexpr size_t PUZZLES_PER_CLAIM = 64;
+
+    // 构造函数：threadCount为0时使用全部硬件线程
+    PuzzleBatchGenerator(bool isComplex, int steps, unsigned int threadCount = 0);
+
+    // 生成count局谜题，第i局的种子为RandomEngine::deriveSeed(baseSeed, i)
+    // 结果与线程数无关；某局谜题反复生成失败时抛出std::runtime_error
+    // 工作线程中抛出的异常在所有线程结束后由本函数重新抛出
+    void generate(size_t count, uint64_t baseSeed);
+
+    // 设置谜题生成选项（起点间隔、起点采样方式等），选项无法生成谜题时抛出std::invalid_argument
+    void setGenerationOptions(const GenerationOptions& generationOptions);
+
+    // 获取已生成的谜题数量
+    size_t getPuzzleCount() const;
+
+    // 每条轨迹包含的格子数（steps + 1）
+    size_t getTrajectoryLength() const;
+
+    // 获取第index局谜题的三条轨迹的起始地址
+    const GridCell* getActualCells(size_t index) const;
+    const GridCell* getRelativeCells(size_t index) const;
+    const GridCell* getFinalCells(size_t index) const;
+
+    // 获取整块输出缓冲区
+    const std::vector<GridCell>& getCells() const;
+
+    // 获取工作线程数
+    unsigned int getThreadCount() const;
+};
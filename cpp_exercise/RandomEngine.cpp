@@ -0,0 +1,35 @@
+#include "RandomEngine.h"
+#include <chrono>
+#include <random>
+using namespace std;
+
+// splitmix64：把任意64位种子扩展成分布良好的状态
+static uint64_t splitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+RandomEngine::RandomEngine(uint64_t seedValue) {
+    seed(seedValue);
+}
+
+void RandomEngine::seed(uint64_t seedValue) {
+    uint64_t x = seedValue;
+    for (int i = 0; i < 4; i++) {
+        state[i] = splitMix64(x);
+    }
+}
+
+uint64_t RandomEngine::deriveSeed(uint64_t baseSeed, uint64_t index) {
+    uint64_t x = baseSeed ^ (index * 0xd1b54a32d192ed03ULL);
+    return splitMix64(x);
+}
+
+uint64_t RandomEngine::randomSeed() {
+    random_device device;
+    uint64_t entropy = (static_cast<uint64_t>(device()) << 32) ^ device();
+    uint64_t ticks = static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+    return splitMix64(entropy) ^ ticks;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+// 随机数引擎（xoshiro256**），每个对象持有独立状态，替代全局的srand/rand
+// 同一个64位种子总是产生同一个随机序列，可以在不同线程中各自使用
+class RandomEngine {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    // 满足标准库UniformRandomBitGenerator的要求
+    typedef uint64_t result_type;
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+    // 构造函数：使用指定种子
+    explicit RandomEngine(uint64_t seedValue = 0);
+
+    // 重新设置种子（用splitmix64把64位种子扩展成256位状态）
+    void seed(uint64_t seedValue);
+
+    // 生成下一个64位随机数
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    uint64_t operator()() {
+        return next();
+    }
+
+    // 生成[0, bound)范围内均匀分布的整数（Lemire乘法取高位 + 拒绝采样去偏）
+    int nextInt(int bound) {
+        uint32_t range = static_cast<uint32_t>(bound);
+        uint64_t product = (next() >> 32) * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+            uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                product = (next() >> 32) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+
+    // 生成[minValue, maxValue]范围内均匀分布的整数
+    int nextInt(int minValue, int maxValue) {
+        return minValue + nextInt(maxValue - minValue + 1);
+    }
+
+    // 生成[0, bound)范围内均匀分布的64位下标（取模 + 拒绝采样去偏，bound可以超过int范围）
+    uint64_t nextIndex(uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        uint64_t value = next();
+        while (value < threshold) {
+            value = next();
+        }
+        return value % bound;
+    }
+
+    // 从系统熵源和时钟生成一个不可预测的种子
+    static uint64_t randomSeed();
+
+    // 由基础种子和序号派生出互不相关的子种子（用于批量生成时每个谜题独立的种子）
+    static uint64_t deriveSeed(uint64_t baseSeed, uint64_t index);
+};
@@ -0,0 +1,38 @@
+#include "RoundArena.h"
+#include <algorithm>
+using namespace std;
+
+void* RoundArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    bytesAllocated += bytes;
+    return pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RoundArena::CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool RoundArena::CountingResource::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+RoundArena::RoundArena(size_t initialBytes)
+    : buffer(new unsigned char[initialBytes]), bufferSize(initialBytes) {
+    rebuild();
+}
+
+void RoundArena::rebuild() {
+    rounds.emplace(buffer.get(), bufferSize, &upstream);
+    scratch.emplace(&*rounds);
+}
+
+void RoundArena::reset() {
+    // 先销毁建立在rounds之上的scratch，再销毁rounds（把额外的块还给堆）
+    scratch.reset();
+    rounds.reset();
+    if (upstream.bytesAllocated > 0 && bufferSize < MAX_RETAINED_BYTES) {
+        bufferSize = min(bufferSize + upstream.bytesAllocated, MAX_RETAINED_BYTES);
+        buffer.reset(new unsigned char[bufferSize]);
+    }
+    upstream.bytesAllocated = 0;
+    rebuild();
+}
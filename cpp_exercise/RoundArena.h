@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// 单局内存池：一局的谜题（轨迹、占用表、位置索引）、玩家的预测轨迹和渲染缓冲区都从这里分配，
+// 这些对象释放时不归还内存，整局结束后由reset()一次性回收
+// 只能在一个线程中使用：同一时刻只能有一个线程在其中分配
+class RoundArena {
+private:
+    // 初始缓冲区用完后的后备资源：转发到堆，并统计本局向堆申请了多少字节
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t bytesAllocated = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::unique_ptr<unsigned char[]> buffer;   // 跨局复用的初始缓冲区
+    size_t bufferSize;
+    CountingResource upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> rounds;        // 单调分配，释放为空操作
+    std::optional<std::pmr::unsynchronized_pool_resource> scratch;    // 建立在rounds之上，局内释放的块可以再次使用
+
+    // 在当前缓冲区上重新建立两层资源
+    void rebuild();
+
+public:
+    // 初始缓冲区的默认大小，足够一局标准谜题和预测轨迹使用
+    static constexpr size_t DEFAULT_INITIAL_BYTES = 64 * 1024;
+
+    // reset()时缓冲区最多扩大到的大小，超长轨迹的局不会让缓冲区一直占着大量内存
+    static constexpr size_t MAX_RETAINED_BYTES = 4 * 1024 * 1024;
+
+    explicit RoundArena(size_t initialBytes = DEFAULT_INITIAL_BYTES);
+
+    RoundArena(const RoundArena&) = delete;
+    RoundArena& operator=(const RoundArena&) = delete;
+
+    // 本局长期存在的对象（谜题、预测轨迹）使用的资源
+    std::pmr::memory_resource* getResource() {
+        return &*rounds;
+    }
+
+    // 局内反复申请和释放的临时缓冲区（如每次渲染的网格）使用的资源，释放的块在本局内复用
+    std::pmr::memory_resource* getScratchResource() {
+        return &*scratch;
+    }
+
+    // 回收本局的全部分配；本局超出了初始缓冲区时，把缓冲区扩大到本局的用量，下一局不再访问堆
+    // 调用时不能再有对象使用本局分配的内存
+    void reset();
+
+    // 当前初始缓冲区的大小
+    size_t getBufferSize() const {
+        return bufferSize;
+    }
+};
@@ -0,0 +1,179 @@
+#include "SimilarityKernel.h"
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+// 只在GCC/Clang的x86目标上编译SIMD内核：用target属性单独为内核函数打开指令集，
+// 其余代码仍按基础指令集编译，在不支持AVX2的CPU上也能运行
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMILARITY_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// 参考轨迹补齐位置的填充值
+static const uint64_t PADDING_KEY = 0x8000000080000000ULL;
+
+// 每组比较的格子数（AVX2一次4格），参考轨迹按此补齐
+static const size_t KEYS_PER_GROUP = 4;
+
+static void countMatchesScalar(const uint64_t* reference, size_t compared, const GridCell* candidates,
+                               size_t candidateCount, size_t length, uint32_t* matches) {
+    for (size_t k = 0; k < candidateCount; k++) {
+        const GridCell* candidate = candidates + k * length + 1;
+        uint32_t count = 0;
+        for (size_t i = 0; i < compared; i++) {
+            count += candidate[i].key() == reference[i];
+        }
+        matches[k] = count;
+    }
+}
+
+#ifdef SIMILARITY_KERNEL_X86
+
+__attribute__((target("sse2"))) static void countMatchesSse2(const uint64_t* reference, size_t compared,
+                                                             const GridCell* candidates, size_t candidateCount,
+                                                             size_t length, uint32_t* matches) {
+    // SSE2没有64位相等比较：按32位比较后，与交换了高低半部分的结果相与
+    size_t pairs = compared / 2;
+    for (size_t k = 0; k < candidateCount; k++) {
+        const GridCell* candidate = candidates + k * length + 1;
+        uint32_t count = 0;
+        for (size_t p = 0; p < pairs; p++) {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate + 2 * p));
+            __m128i expected = _mm_load_si128(reinterpret_cast<const __m128i*>(reference + 2 * p));
+            __m128i halves = _mm_cmpeq_epi32(values, expected);
+            __m128i equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+            int mask = _mm_movemask_pd(_mm_castsi128_pd(equal));
+            count += (mask & 1) + (mask >> 1);
+        }
+        if (compared & 1) {
+            count += candidate[compared - 1].key() == reference[compared - 1];
+        }
+        matches[k] = count;
+    }
+}
+
+__attribute__((target("avx2,popcnt"))) static void countMatchesAvx2(const uint64_t* reference, size_t compared,
+                                                                    const GridCell* candidates, size_t candidateCount,
+                                                                    size_t length, uint32_t* matches) {
+    size_t groups = compared / KEYS_PER_GROUP;
+    size_t tail = compared % KEYS_PER_GROUP;
+    // 最后不满4格的一组用掩码加载，不会读到候选之外的内存；掩掉的通道不计数
+    int tailBits = (1 << tail) - 1;
+    __m256i tailMask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(tail)),
+                                          _mm256_set_epi64x(3, 2, 1, 0));
+    __m256i tailReference = _mm256_load_si256(reinterpret_cast<const __m256i*>(reference + groups * KEYS_PER_GROUP));
+    for (size_t k = 0; k < candidateCount; k++) {
+        const GridCell* candidate = candidates + k * length + 1;
+        uint32_t count = 0;
+        for (size_t g = 0; g < groups; g++) {
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidate + g * KEYS_PER_GROUP));
+            __m256i expected = _mm256_load_si256(reinterpret_cast<const __m256i*>(reference + g * KEYS_PER_GROUP));
+            __m256i equal = _mm256_cmpeq_epi64(values, expected);
+            count += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(equal)));
+        }
+        if (tail != 0) {
+            __m256i values = _mm256_maskload_epi64(
+                reinterpret_cast<const long long*>(candidate + groups * KEYS_PER_GROUP), tailMask);
+            __m256i equal = _mm256_cmpeq_epi64(values, tailReference);
+            count += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(equal)) & tailBits);
+        }
+        matches[k] = count;
+    }
+}
+
+#endif
+
+SimilarityKernel::SimilarityKernel(TrajectoryView reference)
+    : referenceLength(reference.getLength()), implementation(bestImplementation()) {
+    // 下标0不参与比较；末尾至少多补一整组，尾部那一组总能按对齐方式整组读取
+    size_t compared = referenceLength > 1 ? referenceLength - 1 : 0;
+    size_t padded = (compared / KEYS_PER_GROUP + 1) * KEYS_PER_GROUP;
+    referenceKeys.assign(padded, PADDING_KEY);
+    for (size_t i = 0; i < compared; i++) {
+        referenceKeys[i] = reference[i + 1].key();
+    }
+}
+
+void SimilarityKernel::countMatches(const GridCell* candidates, size_t candidateCount, size_t length,
+                                    uint32_t* matches) const {
+    size_t n = min(length, referenceLength);
+    if (n <= 1) {
+        fill(matches, matches + candidateCount, 0);
+        return;
+    }
+    size_t compared = n - 1;
+    switch (implementation) {
+#ifdef SIMILARITY_KERNEL_X86
+    case AVX2_KERNEL:
+        countMatchesAvx2(referenceKeys.data(), compared, candidates, candidateCount, length, matches);
+        return;
+    case SSE2_KERNEL:
+        countMatchesSse2(referenceKeys.data(), compared, candidates, candidateCount, length, matches);
+        return;
+#endif
+    default:
+        countMatchesScalar(referenceKeys.data(), compared, candidates, candidateCount, length, matches);
+        return;
+    }
+}
+
+vector<uint32_t> SimilarityKernel::countMatches(const GridCell* candidates, size_t candidateCount,
+                                                size_t length) const {
+    vector<uint32_t> matches(candidateCount);
+    countMatches(candidates, candidateCount, length, matches.data());
+    return matches;
+}
+
+double SimilarityKernel::similarity(uint32_t matchCount, size_t length) const {
+    size_t n = min(length, referenceLength);
+    if (n <= 1) {
+        return 0.0;
+    }
+    return static_cast<double>(matchCount) / (n - 1);
+}
+
+void SimilarityKernel::setImplementation(Implementation kernel) {
+    if (!isSupported(kernel)) {
+        throw invalid_argument("当前CPU不支持该相似度内核");
+    }
+    implementation = kernel;
+}
+
+SimilarityKernel::Implementation SimilarityKernel::getImplementation() const {
+    return implementation;
+}
+
+bool SimilarityKernel::isSupported(Implementation kernel) {
+    switch (kernel) {
+    case SCALAR_KERNEL:
+        return true;
+#ifdef SIMILARITY_KERNEL_X86
+    case SSE2_KERNEL:
+        return __builtin_cpu_supports("sse2");
+    case AVX2_KERNEL:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+    default:
+        return false;
+    }
+}
+
+SimilarityKernel::Implementation SimilarityKernel::bestImplementation() {
+    // CPU特性只检测一次
+    static const Implementation best = isSupported(AVX2_KERNEL)   ? AVX2_KERNEL
+                                       : isSupported(SSE2_KERNEL) ? SSE2_KERNEL
+                                                                  : SCALAR_KERNEL;
+    return best;
+}
+
+const char* SimilarityKernel::implementationName(Implementation kernel) {
+    switch (kernel) {
+    case AVX2_KERNEL:
+        return "AVX2";
+    case SSE2_KERNEL:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
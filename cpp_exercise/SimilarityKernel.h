@@ -0,0 +1,50 @@
+#pragma once
+#include "AlignedAllocator.h"
+#include "GridCell.h"
+#include "TrajectoryView.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 批量评分：把大量候选预测与同一条参考轨迹（通常是最终轨迹）逐格比较，得到每条候选重合的格子数
+// 规则与Trajectory::calculateSimilarity相同：只比较下标1..n-1（起点由题目给出，不计分），
+// n = min(候选长度, 参考长度)，相似度 = 重合数 / (n - 1)
+// 比较由SIMD内核完成（AVX2每次4格、SSE2每次2格），运行时按CPU支持的指令集选择，不支持时用标量循环
+class SimilarityKernel {
+public:
+    // 内核实现
+    enum Implementation {
+        SCALAR_KERNEL,  // 逐格比较
+        SSE2_KERNEL,    // 128位，一次比较2格
+        AVX2_KERNEL     // 256位，一次比较4格
+    };
+
+private:
+    // 参考轨迹的下标1..n-1，补齐到4格的整数倍；补齐位置是任何坐标都不会等于的值
+    std::vector<uint64_t, AlignedAllocator<uint64_t, 32>> referenceKeys;
+    size_t referenceLength;
+    Implementation implementation;
+
+public:
+    // 构造函数：复制参考轨迹，并选择当前CPU上最快的内核
+    explicit SimilarityKernel(TrajectoryView reference);
+
+    // 给一批候选评分：候选按行连续存放，第k条候选为candidates[k * length, (k + 1) * length)
+    // matches[k]为第k条候选重合的格子数
+    void countMatches(const GridCell* candidates, size_t candidateCount, size_t length, uint32_t* matches) const;
+
+    // 同上，返回每条候选的重合数
+    std::vector<uint32_t> countMatches(const GridCell* candidates, size_t candidateCount, size_t length) const;
+
+    // 长度为length的候选重合matchCount格时的相似度（与calculateSimilarity相同，参与比较的格子不足时为0）
+    double similarity(uint32_t matchCount, size_t length) const;
+
+    // 指定使用的内核（用于对比测试），当前CPU不支持时抛出std::invalid_argument
+    void setImplementation(Implementation kernel);
+    Implementation getImplementation() const;
+
+    // 当前CPU是否支持该内核、支持的最快内核、内核名称
+    static bool isSupported(Implementation kernel);
+    static Implementation bestImplementation();
+    static const char* implementationName(Implementation kernel);
+};
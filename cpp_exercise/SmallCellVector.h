@@ -0,0 +1,194 @@
+#pragma once
+#include "GridCell.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+
+// 小缓冲区优化的GridCell数组：前InlineCapacity个格子直接存放在对象内部，
+// 超过后才从内存资源（默认为堆）分配。接口与std::vector<GridCell>的常用部分一致（迭代器就是指针）
+// 内存资源的传递规则与std::pmr容器相同：复制构造使用默认资源，移动构造沿用对方的资源，赋值不改变自己的资源
+template <size_t InlineCapacity>
+class SmallCellVector {
+private:
+    GridCell* cells;        // 当前使用的存储（内部缓冲区或堆）
+    size_t count;           // 已有的格子数
+    size_t capacity;        // 当前存储的容量
+    std::pmr::memory_resource* resource;    // 超出内部容量时分配存储的内存资源
+    alignas(GridCell) unsigned char inlineStorage[InlineCapacity * sizeof(GridCell)];
+
+    GridCell* inlineCells() {
+        return reinterpret_cast<GridCell*>(inlineStorage);
+    }
+
+    bool isInline() const {
+        return cells == reinterpret_cast<const GridCell*>(inlineStorage);
+    }
+
+    GridCell* allocate(size_t size) {
+        return static_cast<GridCell*>(resource->allocate(size * sizeof(GridCell), alignof(GridCell)));
+    }
+
+    void deallocate(GridCell* pointer, size_t size) {
+        resource->deallocate(pointer, size * sizeof(GridCell), alignof(GridCell));
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            deallocate(cells, capacity);
+        }
+        cells = inlineCells();
+        capacity = InlineCapacity;
+    }
+
+    // 扩容到至少newCapacity（按两倍增长），GridCell可以直接按字节复制
+    void grow(size_t newCapacity) {
+        size_t target = std::max(newCapacity, capacity * 2);
+        GridCell* bigger = allocate(target);
+        std::uninitialized_copy(cells, cells + count, bigger);
+        if (!isInline()) {
+            deallocate(cells, capacity);
+        }
+        cells = bigger;
+        capacity = target;
+    }
+
+public:
+    typedef GridCell value_type;
+    typedef GridCell* iterator;
+    typedef const GridCell* const_iterator;
+
+    SmallCellVector() : SmallCellVector(std::pmr::get_default_resource()) {
+    }
+
+    explicit SmallCellVector(std::pmr::memory_resource* resource)
+        : cells(inlineCells()), count(0), capacity(InlineCapacity), resource(resource) {
+    }
+
+    SmallCellVector(const SmallCellVector& other) : SmallCellVector() {
+        *this = other;
+    }
+
+    SmallCellVector(SmallCellVector&& other) noexcept : SmallCellVector(other.resource) {
+        *this = std::move(other);
+    }
+
+    ~SmallCellVector() {
+        releaseHeap();
+    }
+
+    SmallCellVector& operator=(const SmallCellVector& other) {
+        if (this != &other) {
+            count = 0;
+            reserve(other.count);
+            std::uninitialized_copy(other.cells, other.cells + other.count, cells);
+            count = other.count;
+        }
+        return *this;
+    }
+
+    SmallCellVector& operator=(SmallCellVector&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.isInline()) {
+            // 对方在内部缓冲区里，只能复制（容量不超过InlineCapacity，不会分配）
+            count = 0;
+            std::uninitialized_copy(other.cells, other.cells + other.count, cells);
+            count = other.count;
+        } else if (!resource->is_equal(*other.resource)) {
+            // 两边的内存资源不同，不能接管对方的存储，复制到自己的资源里
+            *this = static_cast<const SmallCellVector&>(other);
+        } else {
+            // 对方在外部存储上且资源相同，直接接管它的存储
+            releaseHeap();
+            cells = other.cells;
+            count = other.count;
+            capacity = other.capacity;
+            other.cells = other.inlineCells();
+            other.capacity = InlineCapacity;
+        }
+        other.count = 0;
+        return *this;
+    }
+
+    void push_back(const GridCell& cell) {
+        if (count == capacity) {
+            GridCell copy = cell;   // cell可能就在本数组里，扩容前先复制
+            grow(count + 1);
+            new (cells + count) GridCell(copy);
+        } else {
+            new (cells + count) GridCell(cell);
+        }
+        count++;
+    }
+
+    void pop_back() {
+        count--;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    // 改变格子数，新增的格子为(0,0)
+    void resize(size_t newCount) {
+        reserve(newCount);
+        for (size_t i = count; i < newCount; i++) {
+            new (cells + i) GridCell();
+        }
+        count = newCount;
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > capacity) {
+            grow(newCapacity);
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t getCapacity() const { return capacity; }
+    std::pmr::memory_resource* getResource() const { return resource; }
+
+    // 当前是否完全存放在对象内部（没有堆分配）
+    bool usesInlineStorage() const { return isInline(); }
+
+    GridCell& operator[](size_t index) { return cells[index]; }
+    const GridCell& operator[](size_t index) const { return cells[index]; }
+
+    GridCell& at(size_t index) {
+        if (index >= count) {
+            throw std::out_of_range("Index out of range");
+        }
+        return cells[index];
+    }
+    const GridCell& at(size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("Index out of range");
+        }
+        return cells[index];
+    }
+
+    GridCell& front() { return cells[0]; }
+    const GridCell& front() const { return cells[0]; }
+    GridCell& back() { return cells[count - 1]; }
+    const GridCell& back() const { return cells[count - 1]; }
+
+    GridCell* data() { return cells; }
+    const GridCell* data() const { return cells; }
+
+    iterator begin() { return cells; }
+    iterator end() { return cells + count; }
+    const_iterator begin() const { return cells; }
+    const_iterator end() const { return cells + count; }
+
+    bool operator==(const SmallCellVector& other) const {
+        return count == other.count && std::equal(cells, cells + count, other.cells);
+    }
+    bool operator!=(const SmallCellVector& other) const {
+        return !(*this == other);
+    }
+};
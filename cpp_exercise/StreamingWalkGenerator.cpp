@@ -0,0 +1,339 @@
+#include "StreamingWalkGenerator.h"
+#include "Lattice.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+
+StreamingWalkGenerator::StreamingWalkGenerator(bool isComplex, uint64_t seedValue, size_t chunkSize)
+    : complex(isComplex), rng(seedValue), chunkSize(max<size_t>(chunkSize, 1)), floodLimit(1 << 18),
+      visited(OccupancyGrid::unbounded()), minRow(0), maxRow(0), minCol(0), maxCol(0),
+      currentStamp(0), floodFillCount(0), backtrackCount(0) {
+}
+
+void StreamingWalkGenerator::setFloodLimit(size_t limit) {
+    floodLimit = max<size_t>(limit, 1);
+}
+
+uint64_t StreamingWalkGenerator::getFloodFillCount() const {
+    return floodFillCount;
+}
+
+uint64_t StreamingWalkGenerator::getBacktrackCount() const {
+    return backtrackCount;
+}
+
+uint64_t StreamingWalkGenerator::generate(uint64_t steps, const ChunkConsumer& consumer) {
+    return dispatchLattice(complex, [&](auto lattice) {
+        return generateOn<decltype(lattice)>(steps, consumer);
+    });
+}
+
+uint64_t StreamingWalkGenerator::generateToFile(uint64_t steps, const string& path) {
+    ofstream out(path, ios::trunc);
+    if (!out.is_open()) {
+        throw runtime_error("无法创建轨迹文件: " + path);
+    }
+    uint64_t emitted = generate(steps, [&out](const GridCell* cells, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out << cells[i].getRow() << ' ' << cells[i].getCol() << '\n';
+        }
+    });
+    if (!out.good()) {
+        throw runtime_error("写入轨迹文件失败: " + path);
+    }
+    return emitted;
+}
+
+template <class Lattice>
+void StreamingWalkGenerator::initFrame(Frame& frame, const GridCell& cell) {
+    // 随机打乱方向顺序，已占用的方向和通向封闭口袋的方向直接丢掉
+    int enclosed = findEnclosedDirections<Lattice>(cell);
+    int directions[Lattice::DIRECTION_COUNT];
+    int count = 0;
+    for (int dir = 0; dir < Lattice::DIRECTION_COUNT; dir++) {
+        if (!(enclosed & (1 << dir)) && !visited.contains(latticeStep<Lattice>(cell, dir))) {
+            directions[count++] = dir;
+        }
+    }
+    for (int i = count - 1; i > 0; i--) {
+        swap(directions[i], directions[rng.nextInt(i + 1)]);
+    }
+    // 1/8的概率优先走离原点最远的方向：轨迹头部保持在外接矩形边缘附近，
+    // 洪水填充很快就能走出外接矩形，也很少围出大口袋
+    // 概率取得较小，是因为这点偏置已足以避开大口袋，再大轨迹就会近似一条向外的直线，失去随机游走的形状
+    if (count > 1 && (rng.next() & 7) == 0) {
+        int best = 0;
+        long bestScore = 0;
+        for (int i = 0; i < count; i++) {
+            long score = static_cast<long>(cell.getRow()) * Lattice::ROW_STEP[directions[i]] +
+                         static_cast<long>(cell.getCol()) * Lattice::COL_STEP[directions[i]];
+            if (i == 0 || score > bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        swap(directions[0], directions[best]);
+    }
+
+    frame.cell = cell;
+    frame.pendingDirs = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        frame.pendingDirs = (frame.pendingDirs << 3) | directions[i];
+    }
+    frame.pendingCount = count;
+}
+
+void StreamingWalkGenerator::resetSeen() {
+    // 每轮填充最多越过上限 段数*方向数 个格子，多留64个位置保证表不会被填满
+    size_t capacity = 1;
+    while (capacity < floodLimit * 2 + 64) {
+        capacity <<= 1;
+    }
+    if (stampKeys.size() != capacity) {
+        stampKeys.assign(capacity, 0);
+        stamps.assign(capacity, 0);
+        stampOwners.assign(capacity, 0);
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        fill(stamps.begin(), stamps.end(), 0);
+        currentStamp = 1;
+    }
+}
+
+int StreamingWalkGenerator::markSeen(const GridCell& cell, int owner) {
+    size_t mask = stampKeys.size() - 1;
+    uint64_t key = cell.key();
+    size_t slot = static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+    while (stamps[slot] == currentStamp) {
+        if (stampKeys[slot] == key) {
+            return stampOwners[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    stamps[slot] = currentStamp;
+    stampKeys[slot] = key;
+    stampOwners[slot] = owner;
+    return -1;
+}
+
+template <class Lattice>
+int StreamingWalkGenerator::findEnclosedDirections(const GridCell& cell) {
+    // 把周围一圈的空闲格子按连续段编号（方格的对角格可以连通相邻的两个方向）
+    const int ringSize = Lattice::RING_SIZE;
+    bool ringFree[ringSize];
+    int firstBlocked = -1;
+    for (int i = 0; i < ringSize; i++) {
+        ringFree[i] = !visited.contains(GridCell(cell.getRow() + Lattice::RING_ROW[i],
+                                                 cell.getCol() + Lattice::RING_COL[i]));
+        if (!ringFree[i] && firstBlocked < 0) {
+            firstBlocked = i;
+        }
+    }
+    if (firstBlocked < 0) {
+        return 0;
+    }
+    int ringArc[ringSize];
+    int arcCount = 0;
+    for (int k = 1; k <= ringSize; k++) {
+        int i = (firstBlocked + k) % ringSize;
+        if (!ringFree[i]) {
+            ringArc[i] = -1;
+            continue;
+        }
+        if (!ringFree[(i + ringSize - 1) % ringSize]) {
+            arcCount++;
+        }
+        ringArc[i] = arcCount - 1;
+    }
+
+    // 每个空闲方向所属的段，只统计含有可走方向的段
+    const int dirCount = Lattice::DIRECTION_COUNT;
+    int dirArc[dirCount];
+    int seedDir[ringSize];
+    int usedArcs = 0;
+    fill(seedDir, seedDir + ringSize, -1);
+    for (int dir = 0; dir < dirCount; dir++) {
+        dirArc[dir] = -1;
+        for (int i = 0; i < ringSize; i++) {
+            if (Lattice::RING_ROW[i] == Lattice::ROW_STEP[dir] && Lattice::RING_COL[i] == Lattice::COL_STEP[dir]) {
+                dirArc[dir] = ringArc[i];
+            }
+        }
+        if (dirArc[dir] >= 0 && seedDir[dirArc[dir]] < 0) {
+            seedDir[dirArc[dir]] = dir;
+            usedArcs++;
+        }
+    }
+    if (usedArcs <= 1) {
+        return 0;
+    }
+
+    // 各段同时做洪水填充，相遇的段合并为一组；只剩一组还没填完，或某段走出外接矩形时结束
+    floodFillCount++;
+    resetSeen();
+    if (static_cast<int>(floodQueues.size()) < arcCount) {
+        floodQueues.resize(arcCount);
+    }
+    int parent[ringSize];
+    size_t heads[ringSize];
+    bool active[ringSize];
+    for (int a = 0; a < arcCount; a++) {
+        parent[a] = a;
+        heads[a] = 0;
+        active[a] = seedDir[a] >= 0;
+        floodQueues[a].clear();
+        if (active[a]) {
+            GridCell seed = latticeStep<Lattice>(cell, seedDir[a]);
+            markSeen(seed, a);
+            floodQueues[a].push_back(seed);
+        }
+    }
+    auto findGroup = [&parent](int a) {
+        while (parent[a] != a) {
+            a = parent[a];
+        }
+        return a;
+    };
+
+    size_t marked = usedArcs;
+    int infiniteGroup = -1;
+    while (infiniteGroup < 0 && marked < floodLimit) {
+        // 统计还有段在填充的组数
+        int liveGroups = 0;
+        bool counted[ringSize] = {false};
+        for (int a = 0; a < arcCount; a++) {
+            if (active[a] && !counted[findGroup(a)]) {
+                counted[findGroup(a)] = true;
+                liveGroups++;
+            }
+        }
+        if (liveGroups <= 1) {
+            break;
+        }
+
+        for (int a = 0; a < arcCount && infiniteGroup < 0; a++) {
+            if (!active[a]) {
+                continue;
+            }
+            if (heads[a] == floodQueues[a].size()) {
+                active[a] = false;
+                continue;
+            }
+            GridCell current = floodQueues[a][heads[a]++];
+            if (current.getRow() < minRow || current.getRow() > maxRow ||
+                current.getCol() < minCol || current.getCol() > maxCol) {
+                infiniteGroup = findGroup(a);
+                break;
+            }
+            for (int dir = 0; dir < dirCount; dir++) {
+                GridCell neighbor = latticeStep<Lattice>(current, dir);
+                if (visited.contains(neighbor)) {
+                    continue;
+                }
+                int owner = markSeen(neighbor, a);
+                if (owner < 0) {
+                    floodQueues[a].push_back(neighbor);
+                    marked++;
+                } else if (findGroup(owner) != findGroup(a)) {
+                    parent[findGroup(owner)] = findGroup(a);
+                }
+            }
+        }
+    }
+
+    // 走出外接矩形的组是唯一的无穷大区域，其余组都是口袋；否则已经填完的组是口袋
+    int enclosed = 0;
+    for (int dir = 0; dir < dirCount; dir++) {
+        if (dirArc[dir] < 0) {
+            continue;
+        }
+        int group = findGroup(dirArc[dir]);
+        bool live = false;
+        for (int a = 0; a < arcCount; a++) {
+            if (active[a] && findGroup(a) == group) {
+                live = true;
+            }
+        }
+        if ((infiniteGroup >= 0 && group != infiniteGroup) || (infiniteGroup < 0 && !live)) {
+            enclosed |= 1 << dir;
+        }
+    }
+    return enclosed;
+}
+
+void StreamingWalkGenerator::emit(size_t count, const ChunkConsumer& consumer) {
+    // 把窗口最前面的count个格子交给消费者，之后它们不能再被回溯
+    chunk.clear();
+    for (size_t i = 0; i < count; i++) {
+        chunk.push_back(window[i].cell);
+    }
+    window.erase(window.begin(), window.begin() + count);
+    consumer(chunk.data(), chunk.size());
+}
+
+template <class Lattice>
+uint64_t StreamingWalkGenerator::generateOn(uint64_t steps, const ChunkConsumer& consumer) {
+    visited.clear();
+    window.clear();
+    window.reserve(chunkSize * 2);
+    chunk.reserve(chunkSize);
+    minRow = maxRow = minCol = maxCol = 0;
+    floodFillCount = 0;
+    backtrackCount = 0;
+
+    GridCell origin(0, 0);
+    visited.insert(origin);
+    window.emplace_back();
+    initFrame<Lattice>(window.back(), origin);
+
+    uint64_t emitted = 0;
+    uint64_t length = 1;     // 当前轨迹的格子数（含已输出部分）
+    while (length < steps + 1) {
+        Frame& frame = window.back();
+        if (frame.pendingCount == 0) {
+            // 所有方向都失败，回退一步
+            if (window.size() == 1) {
+                throw runtime_error("流式生成陷入死路，回溯超出了未输出的窗口");
+            }
+            if (backtrackCount >= chunkSize * 64) {
+                throw runtime_error("流式生成陷入死路，回溯次数超出上限");
+            }
+            visited.erase(frame.cell);
+            window.pop_back();
+            length--;
+            backtrackCount++;
+            continue;
+        }
+
+        int dir = frame.pendingDirs & 7;
+        frame.pendingDirs >>= 3;
+        frame.pendingCount--;
+        GridCell from = frame.cell;
+        GridCell next = latticeStep<Lattice>(from, dir);
+        if (visited.contains(next)) {
+            continue;
+        }
+
+        visited.insert(next);
+        minRow = min(minRow, next.getRow());
+        maxRow = max(maxRow, next.getRow());
+        minCol = min(minCol, next.getCol());
+        maxCol = max(maxCol, next.getCol());
+        window.emplace_back();
+        initFrame<Lattice>(window.back(), next);
+        length++;
+
+        // 窗口满了就输出前一半，保留后一半用于回溯
+        if (window.size() >= chunkSize * 2) {
+            emit(chunkSize, consumer);
+            emitted += chunkSize;
+        }
+    }
+
+    size_t rest = window.size();
+    emit(rest, consumer);
+    emitted += rest;
+    return emitted;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "GridCell.h"
+#include "OccupancyGrid.h"
+#include "RandomEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 流式轨迹生成器：在无界棋盘上生成10^5~10^7步的自回避轨迹
+// 轨迹不整条保存在内存中，而是每凑满一块就交给消费者（回调或文件），
+// 内存占用只有窗口内未输出的格子加上自回避用的占用表
+//
+// 每走到一个格子，先看它周围一圈的空闲格子是否被分成了几段：只有一段时空闲区域没有被切开，
+// 所有方向都可走；分成多段时从每段同时做洪水填充，先填完的是封闭口袋，直接剪掉。
+// 无界棋盘上只有一个无穷大的空闲区域，所以某一段走出已访问格子的外接矩形后，其余段都是口袋。
+// 洪水填充有上限，超过上限的段都保留，极少数误判由窗口内的回溯兜底，
+// 需要回退到已输出的格子或回溯次数超过窗口大小的64倍时抛出std::runtime_error
+// 方向随机打乱，另有1/8的概率优先走离原点最远的方向，让轨迹头部留在外接矩形边缘附近，
+// 洪水填充因此很快结束；得到的不是均匀分布的自回避轨迹，用于压力测试和评分基准
+class StreamingWalkGenerator {
+public:
+    // 消费者回调：收到一块连续的格子
+    typedef std::function<void(const GridCell* cells, size_t count)> ChunkConsumer;
+
+    // 构造函数：chunkSize为每次交给消费者的格子数，也是可回溯的窗口大小
+    StreamingWalkGenerator(bool isComplex, uint64_t seedValue, size_t chunkSize = 4096);
+
+    // 生成steps步轨迹（从原点出发，共steps+1个格子），按块交给consumer，返回输出的格子数
+    uint64_t generate(uint64_t steps, const ChunkConsumer& consumer);
+
+    // 生成steps步轨迹并写入文本文件，每行一个格子"row col"；无法写文件时抛出std::runtime_error
+    uint64_t generateToFile(uint64_t steps, const std::string& path);
+
+    // 洪水填充的上限（最多标记的格子数，默认2^18）
+    void setFloodLimit(size_t limit);
+
+    // 统计信息：上一次生成中的洪水填充次数和回溯步数
+    uint64_t getFloodFillCount() const;
+    uint64_t getBacktrackCount() const;
+
+private:
+    struct Frame {
+        GridCell cell;
+        unsigned int pendingDirs;   // 还没尝试的方向，每个方向占3位
+        int pendingCount;
+    };
+
+    bool complex;
+    RandomEngine rng;
+    size_t chunkSize;
+    size_t floodLimit;
+
+    OccupancyGrid visited;          // 整条轨迹（含已输出部分）的占用表
+    std::vector<Frame> window;      // 还未输出的格子，即可回溯的范围
+    std::vector<GridCell> chunk;    // 交给消费者的缓冲区
+    int minRow, maxRow, minCol, maxCol;     // 已访问格子的外接矩形（只扩不缩）
+
+    // 洪水填充用的带时间戳的哈希集合，每次填充只需把时间戳加一即可清空
+    std::vector<uint64_t> stampKeys;
+    std::vector<uint32_t> stamps;
+    uint32_t currentStamp;
+    std::vector<int> stampOwners;   // 标记该格子的是哪一段的洪水填充
+    std::vector<std::vector<GridCell>> floodQueues;     // 每一段各自的洪水填充队列
+
+    uint64_t floodFillCount;
+    uint64_t backtrackCount;
+
+    template <class Lattice>
+    uint64_t generateOn(uint64_t steps, const ChunkConsumer& consumer);
+    template <class Lattice>
+    void initFrame(Frame& frame, const GridCell& cell);
+    template <class Lattice>
+    int findEnclosedDirections(const GridCell& cell);
+
+    // 在时间戳哈希集合中标记格子属于owner段，已被标记过时返回原来的段号，否则返回-1
+    int markSeen(const GridCell& cell, int owner);
+    void resetSeen();
+    void emit(size_t count, const ChunkConsumer& consumer);
+};
@@ -0,0 +1,244 @@
+#include "TerminalScreen.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// 记录每行的起始位置，最后一个元素是末尾（画面以'\n'结尾）
+static void splitLines(const string& frame, vector<size_t>& lines) {
+    lines.clear();
+    size_t start = 0;
+    while (start < frame.size()) {
+        lines.push_back(start);
+        const void* newline = memchr(frame.data() + start, '\n', frame.size() - start);
+        if (newline == nullptr) {
+            start = frame.size();
+        } else {
+            start = static_cast<size_t>(static_cast<const char*>(newline) - frame.data()) + 1;
+        }
+    }
+    lines.push_back(frame.size());
+}
+
+// 一行（不含'\n'）的显示宽度：三、四字节的UTF-8字符（中文等）占2列，其余占1列
+static size_t displayWidth(const char* text, size_t length) {
+    size_t width = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char byte = static_cast<unsigned char>(text[i]);
+        if (byte < 0x80) {
+            width++;
+        } else if (byte >= 0xC0) {
+            width += byte >= 0xE0 ? 2 : 1;
+        }
+    }
+    return width;
+}
+
+static bool isAscii(const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (static_cast<unsigned char>(text[i]) >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TerminalScreen::TerminalScreen(int outputFd)
+    : fd(outputFd), differential(true), pinned(false), screenRows(0), lastOutputBytes(0) {
+}
+
+TerminalScreen::~TerminalScreen() {
+    release();
+}
+
+void TerminalScreen::setDifferential(bool enabled) {
+    if (!enabled) {
+        release();
+    }
+    differential = enabled;
+}
+
+bool TerminalScreen::fitsTerminal(const string& frame, const vector<size_t>& lines, int& rows) const {
+#if defined(_WIN32)
+    // Windows控制台默认不解释ANSI序列，总是整帧输出
+    (void)frame;
+    (void)lines;
+    (void)rows;
+    return false;
+#else
+    if (!isatty(fd)) {
+        return false;
+    }
+    const char* term = getenv("TERM");
+    if (term == nullptr || strcmp(term, "dumb") == 0) {
+        return false;
+    }
+    winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) {
+        return false;
+    }
+    size_t lineCount = lines.size() - 1;
+    if (lineCount + MIN_SCROLL_ROWS > size.ws_row) {
+        return false;
+    }
+    // 任何一行折行都会让行号对不上
+    for (size_t i = 0; i < lineCount; i++) {
+        size_t length = lines[i + 1] - lines[i] - 1;
+        if (displayWidth(frame.data() + lines[i], length) > size.ws_col) {
+            return false;
+        }
+    }
+    rows = size.ws_row;
+    return true;
+#endif
+}
+
+void TerminalScreen::appendCursorMove(size_t line, size_t column) {
+    // 行列从1开始
+    output.append("\x1b[");
+    output.append(to_string(line + 1));
+    output.push_back(';');
+    output.append(to_string(column + 1));
+    output.push_back('H');
+}
+
+void TerminalScreen::appendFullRedraw(const string& frame, size_t lineCount, int rows) {
+    // 取消旧的滚动区域，清屏后从左上角画整帧，再把画面下方设为滚动区域并把光标放到区域顶部
+    output.append("\x1b[r\x1b[H\x1b[2J");
+    output.append(frame);
+    output.append("\x1b[");
+    output.append(to_string(lineCount + 1));
+    output.push_back(';');
+    output.append(to_string(rows));
+    output.push_back('r');
+    appendCursorMove(lineCount, 0);
+}
+
+void TerminalScreen::appendRelease() {
+    // 取消滚动区域后光标回到左上角，移到最后一行并换行，之后的输出从新的一行开始
+    output.append("\x1b[r");
+    appendCursorMove(static_cast<size_t>(screenRows - 1), 0);
+    output.push_back('\n');
+}
+
+bool TerminalScreen::appendDiff(const string& frame) {
+    if (currentLines.size() != previousLines.size()) {
+        return false;
+    }
+    size_t lineCount = currentLines.size() - 1;
+    size_t begin = output.size();
+    bool changed = false;
+    output.append("\x1b" "7");     // 保存光标位置（在滚动区域中）
+    for (size_t i = 0; i < lineCount; i++) {
+        const char* now = frame.data() + currentLines[i];
+        const char* before = previous.data() + previousLines[i];
+        size_t length = currentLines[i + 1] - currentLines[i] - 1;
+        size_t previousLength = previousLines[i + 1] - previousLines[i] - 1;
+        if (length == previousLength && memcmp(now, before, length) == 0) {
+            continue;
+        }
+        changed = true;
+        if (length != previousLength || !isAscii(now, length) || !isAscii(before, length)) {
+            // 无法按字节对应列，整行重写并清除行尾
+            appendCursorMove(i, 0);
+            output.append(now, length);
+            output.append("\x1b[K");
+            continue;
+        }
+        // 按变化的字节段覆盖写，间隔很近的两段合并成一段
+        size_t j = 0;
+        while (j < length) {
+            if (now[j] == before[j]) {
+                j++;
+                continue;
+            }
+            size_t start = j;
+            size_t end = j + 1;
+            for (size_t k = j + 1; k < length && k - end < MERGE_GAP; k++) {
+                if (now[k] != before[k]) {
+                    end = k + 1;
+                }
+            }
+            appendCursorMove(i, start);
+            output.append(now + start, end - start);
+            j = end;
+        }
+    }
+    output.append("\x1b" "8");     // 恢复光标位置
+    if (output.size() - begin > frame.size()) {
+        output.resize(begin);
+        return false;
+    }
+    if (!changed) {
+        output.resize(begin);
+    }
+    return true;
+}
+
+void TerminalScreen::present(const string& frame) {
+    output.clear();
+    splitLines(frame, currentLines);
+    int rows = 0;
+    if (!differential || !fitsTerminal(frame, currentLines, rows)) {
+        if (pinned) {
+            appendRelease();
+            pinned = false;
+        }
+        output.append(frame);
+    } else if (!pinned || rows != screenRows || !appendDiff(frame)) {
+        appendFullRedraw(frame, currentLines.size() - 1, rows);
+        pinned = true;
+        screenRows = rows;
+    }
+    writeOutput();
+    previous.assign(frame);
+    previousLines.swap(currentLines);
+}
+
+void TerminalScreen::release() {
+    output.clear();
+    if (pinned) {
+        appendRelease();
+        pinned = false;
+    }
+    writeOutput();
+}
+
+size_t TerminalScreen::getLastOutputBytes() const {
+    return lastOutputBytes;
+}
+
+void TerminalScreen::writeOutput() {
+    lastOutputBytes = output.size();
+    if (output.empty()) {
+        return;
+    }
+    cout.flush();
+    fflush(stdout);
+    const char* data = output.data();
+    size_t remaining = output.size();
+    while (remaining > 0) {
+#if defined(_WIN32)
+        int written = _write(fd, data, static_cast<unsigned int>(remaining));
+#else
+        ssize_t written = ::write(fd, data, remaining);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "写出画面失败: " << strerror(errno) << endl;
+            return;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 终端输出：记住屏幕上当前显示的画面，下一帧只输出变化的部分（ANSI光标移动 + 覆盖写）
+// 差分模式下画面固定在屏幕顶部，画面下方设为滚动区域，提示和输入在其中滚动，不会把画面推走
+// 输出不是终端、TERM为dumb、终端放不下整帧或关闭了差分时，退回到整帧输出（与之前的输出完全相同）
+// 画面是以'\n'结尾的若干行；只含ASCII字符的行按字节对应列逐段比较，其余的行有变化时整行重写
+class TerminalScreen {
+private:
+    int fd;                             // 输出的文件描述符
+    bool differential;                  // 是否允许差分输出
+    bool pinned;                        // 画面是否固定在屏幕顶部（下一帧可以差分）
+    int screenRows;                     // 固定画面时终端的行数
+    std::string previous;               // 屏幕上当前显示的画面
+    std::vector<size_t> previousLines;  // previous中每行的起始位置
+    std::vector<size_t> currentLines;
+    std::string output;                 // 本次要写出的字节
+    size_t lastOutputBytes;
+
+    // 差分时，两段变化之间相同的字节少于这个数就一起重写（光标移动序列本身约8个字节）
+    static const size_t MERGE_GAP = 8;
+
+    // 画面下方至少留给滚动区域的行数
+    static const int MIN_SCROLL_ROWS = 5;
+
+    // 终端能否放下这一帧，能放下时得到终端行数
+    bool fitsTerminal(const std::string& frame, const std::vector<size_t>& lines, int& rows) const;
+
+    void appendCursorMove(size_t line, size_t column);
+    void appendFullRedraw(const std::string& frame, size_t lineCount, int rows);
+    void appendRelease();
+
+    // 生成与previous的差分，行数不同或差分比整帧还大时返回false
+    bool appendDiff(const std::string& frame);
+
+    void writeOutput();
+
+public:
+    // 构造函数：fd默认为标准输出
+    explicit TerminalScreen(int outputFd = 1);
+
+    // 析构时释放滚动区域
+    ~TerminalScreen();
+
+    TerminalScreen(const TerminalScreen&) = delete;
+    TerminalScreen& operator=(const TerminalScreen&) = delete;
+
+    // 开启/关闭差分输出（关闭时每帧整帧输出）
+    void setDifferential(bool enabled);
+
+    // 显示一帧：能差分时只输出变化的部分，否则整帧输出；写出前先刷新cout/stdout中尚未输出的内容
+    void present(const std::string& frame);
+
+    // 取消滚动区域并把光标移到屏幕底部，之后的输出正常滚动；下一帧整帧重画
+    // 清屏或切换到其他界面之前调用
+    void release();
+
+    // 最近一次present/release写出的字节数
+    size_t getLastOutputBytes() const;
+};
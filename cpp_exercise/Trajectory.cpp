@@ -3,24 +3,51 @@
 #include <stdexcept>
 using namespace std;
 //Trajectory内存储着一堆GridCell，表示一个对象的移动轨迹
-Trajectory::Trajectory() {
+Trajectory::Trajectory() : indexed(false) {
     // 构造函数初始化空轨迹
     // currentCell默认为(0,0)
 }
 
+Trajectory::Trajectory(std::pmr::memory_resource* resource)
+    : cells(resource), cellIndex(resource), indexed(false) {
+}
+
 void Trajectory::addCell(const GridCell& cell) {
     // 向轨迹中添加一个网格单元
     cells.push_back(cell);
+    if (indexed) {
+        cellIndex.insert(cell, static_cast<long>(cells.size()) - 1);
+    }
     // 同时更新当前位置
     setCurrentCell(cell);
 }
 
-const std::vector<GridCell>& Trajectory::getCells() const {
+void Trajectory::removeLastCell() {
+    // 移除最后一个网格单元
+    if (cells.empty()) {
+        return;
+    }
+    if (indexed) {
+        cellIndex.erase(cells.back(), static_cast<long>(cells.size()) - 1);
+    }
+    cells.pop_back();
+    // 当前位置回退到新的末尾
+    if (!cells.empty()) {
+        setCurrentCell(cells.back());
+    }
+}
+
+void Trajectory::reserve(size_t capacity) {
+    // 预留容量，clear()不会释放已预留的空间
+    cells.reserve(capacity);
+}
+
+const Trajectory::CellList& Trajectory::getCells() const {
     // 返回包含所有网格单元的向量
     return cells;
 }
 
-std::vector<GridCell>& Trajectory::getCells() {
+Trajectory::CellList& Trajectory::getCells() {
     // 返回包含所有网格单元的向量（非const版本）
     return cells;
 }
@@ -68,9 +95,54 @@ double Trajectory::calculateSimilarity(const Trajectory& other) const {
     return c;
 }
 
+double Trajectory::dtwDistance(const Trajectory& other, int band, double abandonAbove) const {
+    return ::dtwDistance(view(), other.view(), band, abandonAbove);
+}
+
+double Trajectory::frechetDistance(const Trajectory& other, int band, double abandonAbove) const {
+    return ::frechetDistance(view(), other.view(), band, abandonAbove);
+}
+
+double Trajectory::hausdorffDistance(const Trajectory& other, double abandonAbove) const {
+    return ::hausdorffDistance(view(), other.view(), abandonAbove);
+}
+
+void Trajectory::enableIndex(int minCoord, int maxCoord) {
+    cellIndex = CellIndex(minCoord, maxCoord, cellIndex.getResource());
+    indexed = true;
+    for (size_t i = 0; i < cells.size(); i++) {
+        cellIndex.insert(cells[i], static_cast<long>(i));
+    }
+}
+
+void Trajectory::enableIndex() {
+    cellIndex = CellIndex(cellIndex.getResource());
+    indexed = true;
+    for (size_t i = 0; i < cells.size(); i++) {
+        cellIndex.insert(cells[i], static_cast<long>(i));
+    }
+}
+
+std::pmr::memory_resource* Trajectory::getResource() const {
+    return cells.getResource();
+}
+
+bool Trajectory::hasIndex() const {
+    return indexed;
+}
+
+long Trajectory::indexOf(const GridCell& cell) const {
+    return view().indexOf(cell);
+}
+
+bool Trajectory::contains(const GridCell& cell) const {
+    return indexOf(cell) >= 0;
+}
+
 void Trajectory::clear() {
     // 清空轨迹
     cells.clear();
+    cellIndex.clear();
     // 重置当前位置为默认值
     //currentCell = GridCell(0, 0);
 } 
\ No newline at end of file
@@ -1,30 +1,69 @@
 #pragma once
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
 #include "GridCell.h"
+#include "CellIndex.h"
+#include "SmallCellVector.h"
+#include "TrajectoryView.h"
+#include "TrajectoryDistance.h"
+
+// 轨迹对象内部直接存放的格子数，标准模式每局约11个格子，默认32足够整局不分配堆内存
+#ifndef TRAJECTORY_INLINE_CAPACITY
+#define TRAJECTORY_INLINE_CAPACITY 32
+#endif
 
 class Trajectory {
+public:
+    typedef SmallCellVector<TRAJECTORY_INLINE_CAPACITY> CellList;
+
 private:
-    std::vector<GridCell> cells;  // 存储轨迹中的所有网格单元
+    CellList cells;  // 存储轨迹中的所有网格单元，超过内部容量才分配堆内存
+    CellIndex cellIndex;    // 可选的位置索引，由addCell/removeLastCell增量维护
+    bool indexed;           // 是否启用了位置索引
     GridCell currentCell;        // 当前位置
 
 public:
     // 构造函数
     Trajectory();
+
+    // 构造函数：超出内部容量的格子和位置索引从resource分配（如本局的RoundArena）
+    // 复制得到的轨迹使用默认资源，赋值不改变轨迹自己的资源
+    explicit Trajectory(std::pmr::memory_resource* resource);
     
     // 添加一个网格单元到轨迹
     void addCell(const GridCell& cell);
+
+    // 移除最后一个网格单元，并把当前位置回退到新的末尾（用于回溯）
+    void removeLastCell();
+
+    // 预留容量，避免生成过程中反复扩容
+    void reserve(size_t capacity);
     
     // 获取轨迹中所有网格单元
-    const std::vector<GridCell>& getCells() const;
+    const CellList& getCells() const;
     
     // 获取轨迹中所有网格单元（非const版本，允许修改）
-    std::vector<GridCell>& getCells();
+    CellList& getCells();
     
     // 获取轨迹中网格单元的数量
     size_t getLength() const;
     
     // 获取指定索引处的网格单元
     GridCell getCell(size_t index) const;
+
+    // 不做边界检查的访问，调用方保证index < getLength()
+    const GridCell& operator[](size_t index) const {
+        return cells[index];
+    }
+
+    // 获取只读视图，只读访问时按视图传递，避免复制轨迹
+    TrajectoryView view() const {
+        return TrajectoryView(cells.data(), cells.size(), indexed ? &cellIndex : nullptr);
+    }
+    operator TrajectoryView() const {
+        return view();
+    }
     
     // 获取当前位置
     const GridCell& getCurrentCell() const;
@@ -32,8 +71,32 @@ public:
     // 设置当前位置
     void setCurrentCell(const GridCell& cell);
     
+    // 启用位置索引：稠密数组覆盖[minCoord, maxCoord]的棋盘，范围外的格子走哈希表
+    void enableIndex(int minCoord, int maxCoord);
+
+    // 启用位置索引：只使用哈希表，适合格子少或无界的轨迹
+    void enableIndex();
+
+    // 是否启用了位置索引
+    bool hasIndex() const;
+
+    // 格子第一次出现的下标，不在轨迹上返回-1；启用索引时为O(1)，否则逐格查找
+    // 通过非const的getCells()直接修改格子后需要重新调用enableIndex
+    long indexOf(const GridCell& cell) const;
+
+    // 格子是否在轨迹上
+    bool contains(const GridCell& cell) const;
+
+    // 分配格子和位置索引的内存资源
+    std::pmr::memory_resource* getResource() const;
+
     // 计算与另一条轨迹的相似度
     double calculateSimilarity(const Trajectory& other) const;
+
+    // 形状距离（越小越相似），band和abandonAbove的含义见TrajectoryDistance.h
+    double dtwDistance(const Trajectory& other, int band = DISTANCE_NO_BAND, double abandonAbove = DISTANCE_NO_LIMIT) const;
+    double frechetDistance(const Trajectory& other, int band = DISTANCE_NO_BAND, double abandonAbove = DISTANCE_NO_LIMIT) const;
+    double hausdorffDistance(const Trajectory& other, double abandonAbove = DISTANCE_NO_LIMIT) const;
     
     // 清空轨迹
     void clear();
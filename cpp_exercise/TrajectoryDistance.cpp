@@ -0,0 +1,157 @@
+#include "TrajectoryDistance.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// 两格距离的平方，用整数计算，不会有舍入误差
+static double squaredDistance(const GridCell& a, const GridCell& b) {
+    int64_t dr = static_cast<int64_t>(a.getRow()) - b.getRow();
+    int64_t dc = static_cast<int64_t>(a.getCol()) - b.getCol();
+    return static_cast<double>(dr * dr + dc * dc);
+}
+
+// DTW与离散Fréchet共用的带状动态规划
+// 较长的轨迹作为行、较短的作为列，缩放后的对角线每行最多右移一格，任何带宽下都存在对齐路径
+// 路径上的值单调不减，一整行的最小值超过阈值时最终结果必然也超过阈值
+// Fréchet只取最大值，直接比较平方距离，最后再开方
+template <bool IsFrechet>
+static double alignedDistance(TrajectoryView a, TrajectoryView b, int band, double abandonAbove) {
+    if (a.empty() || b.empty()) {
+        return a.empty() && b.empty() ? 0.0 : DISTANCE_NO_LIMIT;
+    }
+    if (a.getLength() < b.getLength()) {
+        swap(a, b);
+    }
+    size_t rows = a.getLength();
+    size_t cols = b.getLength();
+    double limit = IsFrechet ? abandonAbove * abandonAbove : abandonAbove;
+
+    // previous为上一行，current中残留着上上一行的值，计算前先把那一段恢复成无穷大
+    vector<double> previous(cols, DISTANCE_NO_LIMIT);
+    vector<double> current(cols, DISTANCE_NO_LIMIT);
+    size_t previousLo = 0, previousHi = 0;
+    size_t staleLo = 1, staleHi = 0;
+
+    for (size_t i = 0; i < rows; i++) {
+        size_t lo = 0;
+        size_t hi = cols - 1;
+        if (band >= 0) {
+            size_t center = rows == 1 ? 0 : (i * (cols - 1) + (rows - 1) / 2) / (rows - 1);
+            lo = center > static_cast<size_t>(band) ? center - band : 0;
+            hi = min(cols - 1, center + band);
+        }
+        for (size_t j = staleLo; j <= staleHi; j++) {
+            current[j] = DISTANCE_NO_LIMIT;
+        }
+
+        double rowMin = DISTANCE_NO_LIMIT;
+        for (size_t j = lo; j <= hi; j++) {
+            double squared = squaredDistance(a[i], b[j]);
+            double cost = IsFrechet ? squared : sqrt(squared);
+            double best;
+            if (i == 0 && j == 0) {
+                best = 0.0;
+            } else {
+                best = previous[j];
+                if (j > 0) {
+                    best = min(best, min(current[j - 1], previous[j - 1]));
+                }
+            }
+            double value = IsFrechet ? max(cost, best) : cost + best;
+            current[j] = value;
+            rowMin = min(rowMin, value);
+        }
+        if (rowMin > limit) {
+            return DISTANCE_NO_LIMIT;
+        }
+
+        swap(previous, current);
+        staleLo = previousLo;
+        staleHi = previousHi;
+        previousLo = lo;
+        previousHi = hi;
+    }
+
+    double result = IsFrechet ? sqrt(previous[cols - 1]) : previous[cols - 1];
+    return result > abandonAbove ? DISTANCE_NO_LIMIT : result;
+}
+
+double dtwDistance(TrajectoryView a, TrajectoryView b, int band, double abandonAbove) {
+    return alignedDistance<false>(a, b, band, abandonAbove);
+}
+
+double frechetDistance(TrajectoryView a, TrajectoryView b, int band, double abandonAbove) {
+    return alignedDistance<true>(a, b, band, abandonAbove);
+}
+
+// 有向Hausdorff距离的平方：from中每一格到to的最近距离的最大值，从已知的下界lowerBound开始
+// 某一格找到不超过当前最大值的距离后就不必再找更近的（提前跳出），最大值超过limit时返回无穷大
+static double directedHausdorffSquared(TrajectoryView from, TrajectoryView to, double lowerBound, double limit) {
+    double maxMin = lowerBound;
+    for (size_t i = 0; i < from.getLength(); i++) {
+        double nearest = DISTANCE_NO_LIMIT;
+        for (size_t j = 0; j < to.getLength(); j++) {
+            nearest = min(nearest, squaredDistance(from[i], to[j]));
+            if (nearest <= maxMin) {
+                break;
+            }
+        }
+        if (nearest > maxMin) {
+            maxMin = nearest;
+            if (maxMin > limit) {
+                return DISTANCE_NO_LIMIT;
+            }
+        }
+    }
+    return maxMin;
+}
+
+double hausdorffDistance(TrajectoryView a, TrajectoryView b, double abandonAbove) {
+    if (a.empty() || b.empty()) {
+        return a.empty() && b.empty() ? 0.0 : DISTANCE_NO_LIMIT;
+    }
+    double limit = abandonAbove * abandonAbove;
+    double forward = directedHausdorffSquared(a, b, 0.0, limit);
+    if (forward == DISTANCE_NO_LIMIT) {
+        return DISTANCE_NO_LIMIT;
+    }
+    // 反方向只有超过正方向的结果时才会改变最终的最大值
+    double both = directedHausdorffSquared(b, a, forward, limit);
+    if (both == DISTANCE_NO_LIMIT) {
+        return DISTANCE_NO_LIMIT;
+    }
+    double result = sqrt(both);
+    return result > abandonAbove ? DISTANCE_NO_LIMIT : result;
+}
+
+double trajectoryDistance(TrajectoryMetric metric, TrajectoryView a, TrajectoryView b, int band, double abandonAbove) {
+    switch (metric) {
+    case FRECHET_METRIC:
+        return frechetDistance(a, b, band, abandonAbove);
+    case HAUSDORFF_METRIC:
+        return hausdorffDistance(a, b, abandonAbove);
+    default:
+        return dtwDistance(a, b, band, abandonAbove);
+    }
+}
+
+long nearestTrajectory(TrajectoryMetric metric, TrajectoryView query, const TrajectoryView* candidates, size_t count,
+                       int band, double* bestDistance) {
+    long bestIndex = -1;
+    double best = DISTANCE_NO_LIMIT;
+    for (size_t k = 0; k < count; k++) {
+        // 只有严格更近的候选才有用，超过目前最好距离的候选会被提前放弃
+        double distance = trajectoryDistance(metric, query, candidates[k], band, best);
+        if (bestIndex < 0 || distance < best) {
+            bestIndex = static_cast<long>(k);
+            best = distance;
+        }
+    }
+    if (bestDistance != nullptr) {
+        *bestDistance = best;
+    }
+    return bestIndex;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "TrajectoryView.h"
+#include <cstddef>
+#include <limits>
+
+// 轨迹形状距离：与逐格重合率不同，预测整体错开一步时仍能得到很小的距离
+// 两格之间的距离为(row, col)坐标的欧氏距离；复杂模式的坐标是显示坐标，距离同样按显示位置计算
+// 动态规划只保留两行，内存为O(较短轨迹的长度)
+
+// 不提前放弃
+const double DISTANCE_NO_LIMIT = std::numeric_limits<double>::infinity();
+
+// 不限制带宽
+const int DISTANCE_NO_BAND = -1;
+
+enum TrajectoryMetric {
+    DTW_METRIC,         // 动态时间规整：最优对齐路径上各格距离之和
+    FRECHET_METRIC,     // 离散Fréchet距离：最优对齐路径上最大的格子距离
+    HAUSDORFF_METRIC    // Hausdorff距离：一条轨迹上的格子到另一条轨迹的最远距离（不考虑顺序）
+};
+
+// 三个距离的共同约定：
+// band >= 0时只允许对齐到对角线附近band格以内（Sakoe-Chiba带，长度不同时沿缩放后的对角线），
+// 带宽至少放宽到能连出一条对齐路径；Hausdorff距离不考虑顺序，忽略band
+// 计算中已经能确定结果大于abandonAbove时立即停止并返回DISTANCE_NO_LIMIT（无穷大）
+// 不大于abandonAbove的结果是精确值；任一轨迹为空时返回无穷大（两条都为空时为0）
+
+double dtwDistance(TrajectoryView a, TrajectoryView b, int band = DISTANCE_NO_BAND,
+                   double abandonAbove = DISTANCE_NO_LIMIT);
+
+double frechetDistance(TrajectoryView a, TrajectoryView b, int band = DISTANCE_NO_BAND,
+                       double abandonAbove = DISTANCE_NO_LIMIT);
+
+double hausdorffDistance(TrajectoryView a, TrajectoryView b, double abandonAbove = DISTANCE_NO_LIMIT);
+
+// 按metric计算距离
+double trajectoryDistance(TrajectoryMetric metric, TrajectoryView a, TrajectoryView b,
+                          int band = DISTANCE_NO_BAND, double abandonAbove = DISTANCE_NO_LIMIT);
+
+// 最近邻查询：在candidates中找与query距离最小的一条，把目前最好的距离作为后续候选的放弃阈值
+// 返回下标（距离相同时取靠前的），没有候选时返回-1；bestDistance不为空时写入最小距离
+long nearestTrajectory(TrajectoryMetric metric, TrajectoryView query, const TrajectoryView* candidates, size_t count,
+                       int band = DISTANCE_NO_BAND, double* bestDistance = nullptr);
@@ -0,0 +1,282 @@
+#include "TrajectoryRenderer.h"
+#include "Lattice.h"
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+TrajectoryRenderer::TrajectoryRenderer()
+    : layerValid(false), layerRevision(0), layerComplex(false), layerFinal(false), gridEnd(0) {
+    frame.reserve(INITIAL_FRAME_BYTES);
+    overlayCells.reserve(INITIAL_OVERLAY_CELLS);
+    staleCells.reserve(INITIAL_OVERLAY_CELLS);
+}
+
+void TrajectoryRenderer::setMarker(int row, int col, char kind, size_t order) {
+    board[row][col][0] = kind;
+    board[row][col][1] = static_cast<char>('0' + order % 10);
+    overlayCells.push_back(row * GRID_SIZE + col);
+}
+
+void TrajectoryRenderer::setHalo(int row, int col, char halo) {
+    board[row][col][1] = halo;
+    overlayCells.push_back(row * GRID_SIZE + col);
+}
+
+template <class Lattice>
+void TrajectoryRenderer::composeStaticLayer(const GameObject& objectA, bool showFinalTrajectory) {
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            board[i][j][0] = ' ';
+            board[i][j][1] = EMPTY_CELL;
+        }
+    }
+
+    TrajectoryView actualTrajectory = objectA.getActualTrajectory();
+    TrajectoryView relativeTrajectory = objectA.getRelativeTrajectory();
+    const int OFFSET = MAX_GRID_COORD;  // 用于将坐标转换为索引的偏移量
+
+    actualLayer.clear();
+    relativeLayer.clear();
+    if (!showFinalTrajectory) {
+        for (size_t i = 0; i < actualTrajectory.getLength(); i++) {
+            actualLayer.set(actualTrajectory[i].getRow() + OFFSET, actualTrajectory[i].getCol() + OFFSET);
+        }
+        for (size_t i = 0; i < relativeTrajectory.getLength(); i++) {
+            relativeLayer.set(relativeTrajectory[i].getRow() + OFFSET, relativeTrajectory[i].getCol() + OFFSET);
+        }
+    }
+
+    // 光晕只画在没有标记的格子上，两条轨迹的光晕相交时实际轨迹的光晕优先
+    LayerBoard markers = actualLayer | relativeLayer;
+    LayerBoard actualHalo = actualLayer.halo<Lattice>();
+    actualHalo.subtract(markers);
+    LayerBoard relativeHalo = relativeLayer.halo<Lattice>();
+    relativeHalo.subtract(markers).subtract(actualHalo);
+    actualHalo.forEachCell([this](int row, int col) { setHalo(row, col, ACTUAL_HALO); });
+    relativeHalo.forEachCell([this](int row, int col) { setHalo(row, col, OTHER_HALO); });
+    staticOccupied = markers | actualHalo | relativeHalo;
+
+    if (!showFinalTrajectory) {
+        // 实际轨迹 (A0, A1, A2, ...)
+        for (size_t i = 0; i < actualTrajectory.getLength(); i++) {
+            int row = actualTrajectory[i].getRow() + OFFSET;
+            int col = actualTrajectory[i].getCol() + OFFSET;
+            if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE) {
+                setMarker(row, col, ACTUAL_PATH, i);
+            }
+        }
+
+        // 相对轨迹 (R0, R1, ...)，与实际轨迹重叠时为C（相对轨迹不会重复经过同一格）
+        for (size_t i = 0; i < relativeTrajectory.getLength(); i++) {
+            int row = relativeTrajectory[i].getRow() + OFFSET;
+            int col = relativeTrajectory[i].getCol() + OFFSET;
+            if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE) {
+                char kind = actualLayer.test(row, col) ? OVERLAP_AR : RELATIVE_PATH;
+                setMarker(row, col, kind, i);
+            }
+        }
+    }
+
+    memcpy(staticLayer, board, sizeof(board));
+}
+
+template <class Lattice>
+void TrajectoryRenderer::overlayPrediction(TrajectoryView predictedPath) {
+    const int OFFSET = MAX_GRID_COORD;
+
+    // 预测层；同一格经过不止一次的格子另记一层，它们保持P标记（显示最新的序号）
+    predictedLayer.clear();
+    revisitedLayer.clear();
+    for (size_t i = 0; i < predictedPath.getLength(); i++) {
+        int row = predictedPath[i].getRow() + OFFSET;
+        int col = predictedPath[i].getCol() + OFFSET;
+        if (predictedLayer.test(row, col)) {
+            revisitedLayer.set(row, col);
+        }
+        predictedLayer.set(row, col);
+    }
+
+    // 按行一趟算出预测轨迹的光晕（同样只画在空格子上）和重叠分类：
+    // 只经过一次的预测格子与实际/相对层整行求交
+    for (int i = 0; i < GRID_SIZE; i++) {
+        uint64_t predicted = predictedLayer.getRow(i);
+        uint64_t actual = actualLayer.getRow(i);
+        uint64_t relative = relativeLayer.getRow(i);
+        uint64_t once = predicted & ~revisitedLayer.getRow(i);
+        predictedHalo.setRow(i, predictedLayer.haloRow<Lattice>(i) & ~staticOccupied.getRow(i) & ~predicted);
+        overlapAll.setRow(i, once & actual & relative);
+        overlapActual.setRow(i, once & actual & ~relative);
+        overlapRelative.setRow(i, once & relative & ~actual);
+    }
+    predictedHalo.forEachCell([this](int row, int col) { setHalo(row, col, OTHER_HALO); });
+
+    // 预测轨迹 (P0, P1, ...)
+    for (size_t i = 0; i < predictedPath.getLength(); i++) {
+        int row = predictedPath[i].getRow() + OFFSET;
+        int col = predictedPath[i].getCol() + OFFSET;
+        if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE) {
+            char kind = PREDICTED_PATH;
+            if (overlapAll.test(row, col)) {
+                kind = OVERLAP_ALL;
+            } else if (overlapActual.test(row, col)) {
+                kind = OVERLAP_AP;
+            } else if (overlapRelative.test(row, col)) {
+                kind = OVERLAP_RP;
+            }
+            setMarker(row, col, kind, i);
+        }
+    }
+}
+
+template <class Lattice>
+bool TrajectoryRenderer::composeBoard(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode,
+                                      bool showFinalTrajectory) {
+    bool rebuilt = false;
+    if (layerValid && layerRevision == objectA.getRevision() && layerComplex == isComplexMode &&
+        layerFinal == showFinalTrajectory) {
+        // 静态层没变，把上一帧预测层画过的格子恢复成静态层的内容，这些格子之后还要写回帧缓冲区
+        for (int index : overlayCells) {
+            int row = index / GRID_SIZE;
+            int col = index % GRID_SIZE;
+            board[row][col][0] = staticLayer[row][col][0];
+            board[row][col][1] = staticLayer[row][col][1];
+        }
+        staleCells.swap(overlayCells);
+    } else {
+        composeStaticLayer<Lattice>(objectA, showFinalTrajectory);
+        layerValid = true;
+        layerRevision = objectA.getRevision();
+        layerComplex = isComplexMode;
+        layerFinal = showFinalTrajectory;
+        staleCells.clear();
+        rebuilt = true;
+    }
+    overlayCells.clear();
+
+    overlayPrediction<Lattice>(predictedPath);
+    return rebuilt;
+}
+
+void TrajectoryRenderer::appendText(const char* text) {
+    frame.append(text);
+}
+
+void TrajectoryRenderer::appendInt(long value) {
+    char digits[24];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+    frame.append(digits, result.ptr);
+}
+
+void TrajectoryRenderer::appendPadded(long value, int width) {
+    // 右对齐到width个字符，与setw(width)相同
+    char digits[24];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+    int length = static_cast<int>(result.ptr - digits);
+    if (length < width) {
+        frame.append(width - length, ' ');
+    }
+    frame.append(digits, result.ptr);
+}
+
+void TrajectoryRenderer::appendGrid(bool showFinalTrajectory) {
+    frame.clear();
+    if (showFinalTrajectory) {
+        appendText("\n");
+    } else {
+        appendText("A0-A9 - 参考轨迹，R0-R9 - 相对轨迹，P0-P9 - 预测轨迹\n");
+        appendText("C - 参考和相对重叠，M - 参考和预测重叠，O - 相对和预测重叠，* - 全部重叠\n");
+    }
+    appendText("数字表示轨迹中点的顺序 (0-9循环)\n");
+
+    // 坐标轴标签
+    appendText("\n坐标范围：X轴和Y轴从 ");
+    appendInt(MIN_GRID_COORD);
+    appendText(" 到 ");
+    appendInt(MAX_GRID_COORD);
+    appendText("\n");
+
+    // 网格：每5行标一次行坐标（5个字符宽），每格2个字符加一个空格
+    for (int i = 0; i < GRID_SIZE; i++) {
+        if (i % 5 == 0) {
+            appendPadded(MIN_GRID_COORD + i, 5);
+            appendText(" ");
+        } else {
+            appendText("      ");
+        }
+        for (int j = 0; j < GRID_SIZE; j++) {
+            frame.push_back(board[i][j][0]);
+            frame.push_back(board[i][j][1]);
+            frame.push_back(' ');
+        }
+        frame.push_back('\n');
+    }
+    gridEnd = frame.size();
+}
+
+void TrajectoryRenderer::patchGrid(const vector<int>& cells) {
+    // 网格每行是6个字符的行坐标、每格3个字符和换行符，格子在帧中的位置固定
+    const size_t ROW_BYTES = 6 + GRID_SIZE * 3 + 1;
+    size_t gridStart = gridEnd - GRID_SIZE * ROW_BYTES;
+    for (int index : cells) {
+        int row = index / GRID_SIZE;
+        int col = index % GRID_SIZE;
+        size_t offset = gridStart + row * ROW_BYTES + 6 + col * 3;
+        frame[offset] = board[row][col][0];
+        frame[offset + 1] = board[row][col][1];
+    }
+}
+
+void TrajectoryRenderer::compose(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode,
+                                 bool showFinalTrajectory) {
+    bool rebuilt = dispatchLattice(isComplexMode, [&](auto lattice) {
+        return composeBoard<decltype(lattice)>(objectA, predictedPath, isComplexMode, showFinalTrajectory);
+    });
+
+    if (rebuilt) {
+        appendGrid(showFinalTrajectory);
+    } else {
+        // 说明文字和网格沿用上一帧，只改写恢复和新画的格子，去掉上一帧网格之后的部分
+        patchGrid(staleCells);
+        patchGrid(overlayCells);
+        frame.resize(gridEnd);
+    }
+
+    // 系统生成的完整实际轨迹（用于测试）
+    TrajectoryView finalTrajectory = objectA.getfinalTrajectory();
+    appendText("\n系统生成的实际轨迹（通过计算得到）：\n");
+    for (size_t i = 0; i < finalTrajectory.getLength(); i++) {
+        appendText("  点");
+        appendInt(static_cast<long>(i));
+        appendText(": 原始坐标(");
+        appendInt(finalTrajectory[i].getRow());
+        appendText(",");
+        appendInt(finalTrajectory[i].getCol());
+        appendText(")\n");
+    }
+}
+
+const string& TrajectoryRenderer::getFrame() const {
+    return frame;
+}
+
+void TrajectoryRenderer::present() {
+    screen.present(frame);
+}
+
+TerminalScreen& TrajectoryRenderer::getScreen() {
+    return screen;
+}
+
+OverlapCounts TrajectoryRenderer::getOverlapCounts() const {
+    return countOverlaps(actualLayer, relativeLayer, predictedLayer, revisitedLayer);
+}
+
+void TrajectoryRenderer::invalidateStaticLayer() {
+    layerValid = false;
+}
+
+void TrajectoryRenderer::render(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode,
+                                bool showFinalTrajectory) {
+    compose(objectA, predictedPath, isComplexMode, showFinalTrajectory);
+    present();
+}
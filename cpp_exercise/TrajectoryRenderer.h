@@ -0,0 +1,120 @@
+#pragma once
+#include "GameObject.h"
+#include "LayerBoard.h"
+#include "TerminalScreen.h"
+#include "TrajectoryView.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 用于控制台可视化的网格大小
+const int GRID_SIZE = 61;
+const char EMPTY_CELL = '.';
+const char ACTUAL_PATH = 'A';
+const char RELATIVE_PATH = 'R';
+const char PREDICTED_PATH = 'P';
+const char OVERLAP_AR = 'C';  // 实际和相对轨迹重叠
+const char OVERLAP_AP = 'M';  // 实际和预测轨迹重叠
+const char OVERLAP_RP = 'O';  // 相对和预测轨迹重叠
+const char OVERLAP_ALL = '*'; // 所有轨迹重叠
+const char ACTUAL_HALO = '#'; // 实际轨迹的六边形光晕
+const char OTHER_HALO = '&';  // 相对/预测轨迹的六边形光晕
+const int MIN_GRID_COORD = -30;
+const int MAX_GRID_COORD = 30;
+
+// 轨迹渲染器：把一帧画面（说明文字、61x61网格、最终轨迹坐标）组合进一块预先分配的字节缓冲区，
+// 再交给TerminalScreen一次写出（终端足够大时只写出与上一帧不同的格子）；网格每格固定2个字节，
+// 不再为每格创建std::string，也不再逐行刷新；同一个渲染器在多帧之间复用缓冲区，稳定后每帧没有内存分配
+// 一局之内实际/相对轨迹（连同光晕）不变，组合好的静态层按谜题版本号缓存，每帧只叠加预测层：
+// 先把上一帧预测层改动过的格子从静态层恢复，再画这一帧的预测轨迹，帧缓冲区中也只改写这些格子，
+// 网格部分的开销与预测长度成正比
+// 每条轨迹在网格上各占一层位图（LayerBoard），重叠分类和光晕由位运算得到，与绘制顺序无关
+class TrajectoryRenderer {
+private:
+    static_assert(LayerBoard::SIZE == GRID_SIZE, "位图层与显示网格大小不一致");
+
+    // 网格每格2个字符，与之前按setw(2)右对齐输出的结果相同（"."显示为" ."）
+    char board[GRID_SIZE][GRID_SIZE][2];
+    char staticLayer[GRID_SIZE][GRID_SIZE][2];  // 只有实际/相对轨迹和它们光晕的网格
+
+    // 静态层对应的谜题版本号和画法，任何一项不同都要重建
+    bool layerValid;
+    uint64_t layerRevision;
+    bool layerComplex;
+    bool layerFinal;
+
+    LayerBoard actualLayer;     // 静态层中的实际轨迹
+    LayerBoard relativeLayer;   // 静态层中的相对轨迹
+    LayerBoard staticOccupied;  // 静态层中有标记或光晕的格子，预测轨迹的光晕不能画在这些格子上
+    LayerBoard predictedLayer;  // 这一帧的预测轨迹
+    LayerBoard revisitedLayer;  // 预测轨迹经过不止一次的格子
+    LayerBoard predictedHalo;   // 这一帧要画的预测轨迹光晕
+    LayerBoard overlapAll;      // 这一帧的重叠分类：*、M、O
+    LayerBoard overlapActual;
+    LayerBoard overlapRelative;
+
+    std::vector<int> overlayCells;  // 预测层改动过的格子（row * GRID_SIZE + col），可能重复
+    std::vector<int> staleCells;    // 上一帧预测层改动过、这一帧已恢复成静态层的格子
+
+    size_t gridEnd;         // 帧中网格结束的位置，之后是最终轨迹的坐标列表
+    std::string frame;      // 组合好的一帧，clear()后保留容量
+    TerminalScreen screen;  // 输出到标准输出，记住上一次显示的画面
+
+    // 初始时预留的帧大小，足够一整帧
+    static const size_t INITIAL_FRAME_BYTES = 16 * 1024;
+    // 初始时预留的预测层格子数，足够几十步预测（每步一个标记加八个光晕）
+    static const size_t INITIAL_OVERLAY_CELLS = 512;
+
+    // 重新画出静态层，并复制到staticLayer
+    template <class Lattice>
+    void composeStaticLayer(const GameObject& objectA, bool showFinalTrajectory);
+
+    // 在静态层之上画预测轨迹
+    template <class Lattice>
+    void overlayPrediction(TrajectoryView predictedPath);
+
+    // 静态层仍然有效时只撤销上一帧的预测层，否则重建静态层；之后叠加这一帧的预测层
+    // 返回是否重建了静态层（此时帧缓冲区中的网格要整个重新写出）
+    template <class Lattice>
+    bool composeBoard(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode,
+                      bool showFinalTrajectory);
+
+    void setMarker(int row, int col, char kind, size_t order);
+    // 画光晕，调用者保证格子在网格内并且是空的
+    void setHalo(int row, int col, char halo);
+
+    // 把说明文字和整个网格写到帧的开头
+    void appendGrid(bool showFinalTrajectory);
+
+    // 把cells中的格子从board写回帧中的网格
+    void patchGrid(const std::vector<int>& cells);
+
+    void appendText(const char* text);
+    void appendInt(long value);
+    void appendPadded(long value, int width);
+
+public:
+    TrajectoryRenderer();
+
+    // 组合一帧画面到缓冲区，不输出
+    void compose(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode, bool showFinalTrajectory);
+
+    // 最近一次组合的画面
+    const std::string& getFrame() const;
+
+    // 输出缓冲区中的画面（差分或整帧，见TerminalScreen）
+    void present();
+
+    // 输出画面的终端，用于开关差分输出、在清屏或切换界面前释放终端
+    TerminalScreen& getScreen();
+
+    // 最近一次组合的网格上各类重叠的格子数（由各层位图现算，不影响渲染的开销）
+    OverlapCounts getOverlapCounts() const;
+
+    // 丢弃缓存的静态层，下一帧重新组合（谜题换掉时版本号会变，通常不需要调用）
+    void invalidateStaticLayer();
+
+    // 组合并输出一帧
+    void render(const GameObject& objectA, TrajectoryView predictedPath, bool isComplexMode, bool showFinalTrajectory);
+};
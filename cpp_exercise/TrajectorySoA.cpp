@@ -0,0 +1,113 @@
+#include "TrajectorySoA.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+TrajectorySoA::TrajectorySoA() {
+}
+
+TrajectorySoA::TrajectorySoA(const Trajectory& trajectory) {
+    assign(trajectory);
+}
+
+int16_t TrajectorySoA::narrow(int value) {
+    if (value < numeric_limits<int16_t>::min() || value > numeric_limits<int16_t>::max()) {
+        throw out_of_range("坐标超出int16_t范围");
+    }
+    return static_cast<int16_t>(value);
+}
+
+void TrajectorySoA::assign(const Trajectory& trajectory) {
+    const Trajectory::CellList& cells = trajectory.getCells();
+    // 先全部检查再写入，出错时不留下一半的内容
+    for (const GridCell& cell : cells) {
+        narrow(cell.getRow());
+        narrow(cell.getCol());
+    }
+    rows.resize(cells.size());
+    cols.resize(cells.size());
+    for (size_t i = 0; i < cells.size(); i++) {
+        rows[i] = static_cast<int16_t>(cells[i].getRow());
+        cols[i] = static_cast<int16_t>(cells[i].getCol());
+    }
+}
+
+Trajectory TrajectorySoA::toTrajectory() const {
+    Trajectory trajectory;
+    trajectory.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        trajectory.addCell(GridCell(rows[i], cols[i]));
+    }
+    return trajectory;
+}
+
+void TrajectorySoA::addCell(const GridCell& cell) {
+    int16_t row = narrow(cell.getRow());
+    int16_t col = narrow(cell.getCol());
+    rows.push_back(row);
+    cols.push_back(col);
+}
+
+void TrajectorySoA::removeLastCell() {
+    if (rows.empty()) {
+        return;
+    }
+    rows.pop_back();
+    cols.pop_back();
+}
+
+void TrajectorySoA::reserve(size_t capacity) {
+    rows.reserve(capacity);
+    cols.reserve(capacity);
+}
+
+size_t TrajectorySoA::getLength() const {
+    return rows.size();
+}
+
+GridCell TrajectorySoA::getCell(size_t index) const {
+    if (index >= rows.size()) {
+        throw out_of_range("Index out of range");
+    }
+    return GridCell(rows[index], cols[index]);
+}
+
+GridCell TrajectorySoA::getCurrentCell() const {
+    if (rows.empty()) {
+        return GridCell(0, 0);
+    }
+    return GridCell(rows.back(), cols.back());
+}
+
+const int16_t* TrajectorySoA::rowData() const {
+    return rows.data();
+}
+
+const int16_t* TrajectorySoA::colData() const {
+    return cols.data();
+}
+
+double TrajectorySoA::calculateSimilarity(const TrajectorySoA& other) const {
+    // 与Trajectory相同：比较下标1..size处的格子，返回重合的比例
+    size_t length = min(rows.size(), other.rows.size());
+    // 与SimilarityKernel::similarity一致：没有可比较的格子时返回0
+    if (length <= 1) {
+        return 0.0;
+    }
+    const int16_t* rowA = rows.data();
+    const int16_t* colA = cols.data();
+    const int16_t* rowB = other.rows.data();
+    const int16_t* colB = other.cols.data();
+    // 无分支的计数循环，编译器可以展开成SIMD比较
+    int matches = 0;
+    for (size_t i = 1; i < length; i++) {
+        matches += (rowA[i] == rowB[i]) & (colA[i] == colB[i]);
+    }
+    return static_cast<double>(matches) / (length - 1);
+}
+
+void TrajectorySoA::clear() {
+    rows.clear();
+    cols.clear();
+}
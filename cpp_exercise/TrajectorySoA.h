@@ -0,0 +1,62 @@
+#pragma once
+#include "AlignedAllocator.h"
+#include "GridCell.h"
+#include "Trajectory.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 结构数组（SoA）形式的轨迹：行坐标和列坐标分别存放在两个连续的int16_t数组中
+// 坐标不会超出±30，int16_t足够，占用只有Trajectory的一半；两个数组按32字节对齐，
+// 逐格比较的循环可以被编译器向量化。通过构造函数/toTrajectory()与Trajectory互相转换
+class TrajectorySoA {
+public:
+    typedef std::vector<int16_t, AlignedAllocator<int16_t, 32>> CoordArray;
+
+private:
+    CoordArray rows;    // 每个格子的行坐标
+    CoordArray cols;    // 每个格子的列坐标
+
+    static int16_t narrow(int value);
+
+public:
+    // 构造函数
+    TrajectorySoA();
+
+    // 从Trajectory转换，坐标超出int16_t范围时抛出std::out_of_range
+    explicit TrajectorySoA(const Trajectory& trajectory);
+
+    // 用Trajectory的内容覆盖本轨迹
+    void assign(const Trajectory& trajectory);
+
+    // 转换回Trajectory
+    Trajectory toTrajectory() const;
+
+    // 添加一个网格单元，坐标超出int16_t范围时抛出std::out_of_range
+    void addCell(const GridCell& cell);
+
+    // 移除最后一个网格单元
+    void removeLastCell();
+
+    // 预留容量
+    void reserve(size_t capacity);
+
+    // 获取网格单元的数量
+    size_t getLength() const;
+
+    // 获取指定索引处的网格单元（越界时抛出std::out_of_range）
+    GridCell getCell(size_t index) const;
+
+    // 获取最后一个网格单元，轨迹为空时返回(0,0)
+    GridCell getCurrentCell() const;
+
+    // 行/列坐标数组的首地址（32字节对齐），供批量评分和渲染直接读取
+    const int16_t* rowData() const;
+    const int16_t* colData() const;
+
+    // 计算与另一条轨迹的相似度，规则与Trajectory::calculateSimilarity相同；不足两个格子时返回0，不输出任何信息
+    double calculateSimilarity(const TrajectorySoA& other) const;
+
+    // 清空轨迹
+    void clear();
+};
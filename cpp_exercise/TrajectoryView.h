@@ -0,0 +1,70 @@
+#pragma once
+#include "CellIndex.h"
+#include "GridCell.h"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+// 轨迹的只读视图：只保存首地址和长度，不拥有数据，复制代价与两个指针相同
+// 视图的有效期不能超过它所指向的轨迹；轨迹被修改（添加格子）后需要重新获取视图
+// 轨迹建立了位置索引时视图也带着索引，contains/indexOf为O(1)，否则逐格查找
+class TrajectoryView {
+private:
+    const GridCell* cells;
+    size_t length;
+    const CellIndex* index;     // 所属轨迹的位置索引，可以为空
+
+public:
+    typedef const GridCell* const_iterator;
+
+    TrajectoryView() : cells(nullptr), length(0), index(nullptr) {
+    }
+
+    TrajectoryView(const GridCell* data, size_t count, const CellIndex* cellIndex = nullptr)
+        : cells(data), length(count), index(cellIndex) {
+    }
+
+    // 获取网格单元的数量
+    size_t getLength() const { return length; }
+    bool empty() const { return length == 0; }
+
+    // 不做边界检查的访问，调用方保证index < getLength()
+    const GridCell& operator[](size_t index) const { return cells[index]; }
+
+    // 带边界检查的访问，越界时抛出std::out_of_range
+    const GridCell& getCell(size_t index) const {
+        if (index >= length) {
+            throw std::out_of_range("Index out of range");
+        }
+        return cells[index];
+    }
+
+    const GridCell& front() const { return cells[0]; }
+    const GridCell& back() const { return cells[length - 1]; }
+    const GridCell* data() const { return cells; }
+    const_iterator begin() const { return cells; }
+    const_iterator end() const { return cells + length; }
+
+    // 格子第一次出现的下标，不在视图范围内返回-1
+    long indexOf(const GridCell& cell) const {
+        if (index != nullptr) {
+            long position = index->indexOf(cell);
+            return position < static_cast<long>(length) ? position : -1;
+        }
+        for (size_t i = 0; i < length; i++) {
+            if (cells[i] == cell) {
+                return static_cast<long>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool contains(const GridCell& cell) const {
+        return indexOf(cell) >= 0;
+    }
+
+    // 前count个格子组成的视图（索引记录的是第一次出现的位置，对前缀同样适用）
+    TrajectoryView prefix(size_t count) const {
+        return TrajectoryView(cells, std::min(count, length), index);
+    }
+};
@@ -0,0 +1,277 @@
+#include "WalkTable.h"
+#include "Lattice.h"
+#include "OccupancyGrid.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+static const char WALK_TABLE_MAGIC[4] = {'T', 'W', 'L', 'K'};
+static const uint32_t WALK_TABLE_VERSION = 1;
+
+static void writeUint32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+static void writeUint64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+static uint32_t readUint32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+static uint64_t readUint64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// 深度优先枚举所有自回避轨迹，每找到一条完整轨迹就写出一条记录
+template <class Lattice>
+static uint64_t enumerateWalks(ofstream& out, int steps, int recordBytes) {
+    const int boardWidth = MAX_TRAJ_COORD - MIN_TRAJ_COORD;
+    const int reach = steps * 3 + 1;
+    OccupancyGrid visited(-reach, reach);
+
+    vector<GridCell> cells(steps + 1);
+    vector<int> nextDir(steps + 1, 0);
+    vector<unsigned char> record(recordBytes);
+    uint64_t count = 0;
+
+    cells[0] = GridCell(0, 0);
+    visited.insert(cells[0]);
+    int depth = 0;
+    while (depth >= 0) {
+        if (depth == steps) {
+            // 只保留能放进棋盘的轨迹（外接矩形不超过棋盘边长）
+            int minRow = 0, maxRow = 0, minCol = 0, maxCol = 0;
+            uint64_t code = 0;
+            for (int k = 1; k <= steps; k++) {
+                minRow = min(minRow, cells[k].getRow());
+                maxRow = max(maxRow, cells[k].getRow());
+                minCol = min(minCol, cells[k].getCol());
+                maxCol = max(maxCol, cells[k].getCol());
+                code |= static_cast<uint64_t>(nextDir[k - 1] - 1) << ((k - 1) * Lattice::DIRECTION_BITS);
+            }
+            if (maxRow - minRow <= boardWidth && maxCol - minCol <= boardWidth) {
+                for (int i = 0; i < recordBytes; i++) {
+                    record[i] = static_cast<unsigned char>(code >> (8 * i));
+                }
+                out.write(reinterpret_cast<const char*>(record.data()), recordBytes);
+                count++;
+            }
+            visited.erase(cells[depth]);
+            depth--;
+            continue;
+        }
+
+        // nextDir[depth]记录当前这一层下一个要尝试的方向
+        if (nextDir[depth] == Lattice::DIRECTION_COUNT) {
+            nextDir[depth] = 0;
+            if (depth > 0) {
+                visited.erase(cells[depth]);
+            }
+            depth--;
+            continue;
+        }
+        int dir = nextDir[depth]++;
+        GridCell next = latticeStep<Lattice>(cells[depth], dir);
+        if (visited.contains(next)) {
+            continue;
+        }
+        visited.insert(next);
+        cells[depth + 1] = next;
+        depth++;
+    }
+    return count;
+}
+
+WalkTable::WalkTable()
+    : records(nullptr), walkCount(0), steps(0), complex(false), bitsPerStep(0), recordBytes(0),
+      mappedData(nullptr), mappedSize(0) {
+}
+
+WalkTable::~WalkTable() {
+    close();
+}
+
+void WalkTable::close() {
+#if !defined(_WIN32)
+    if (mappedData != nullptr) {
+        munmap(mappedData, mappedSize);
+    }
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+    fileData.clear();
+    records = nullptr;
+    walkCount = 0;
+}
+
+uint64_t WalkTable::build(const string& path, bool isComplex, int steps) {
+    int bits = isComplex ? HexLattice6::DIRECTION_BITS : SquareLattice4::DIRECTION_BITS;
+    if (steps <= 0 || steps * bits > 64) {
+        throw invalid_argument("步数超出轨迹表单条记录的容量");
+    }
+    int recordBytes = (steps * bits + 7) / 8;
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        throw runtime_error("无法创建轨迹表文件: " + path);
+    }
+
+    // 先写占位的文件头，枚举完成后再回填轨迹条数
+    unsigned char header[HEADER_BYTES] = {0};
+    memcpy(header, WALK_TABLE_MAGIC, 4);
+    writeUint32(header + 4, WALK_TABLE_VERSION);
+    writeUint32(header + 8, isComplex ? 1 : 0);
+    writeUint32(header + 12, static_cast<uint32_t>(steps));
+    writeUint32(header + 16, static_cast<uint32_t>(bits));
+    writeUint32(header + 20, static_cast<uint32_t>(recordBytes));
+    out.write(reinterpret_cast<const char*>(header), HEADER_BYTES);
+
+    uint64_t count = isComplex ? enumerateWalks<HexLattice6>(out, steps, recordBytes)
+                               : enumerateWalks<SquareLattice4>(out, steps, recordBytes);
+
+    writeUint64(header + 24, count);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header), HEADER_BYTES);
+    if (!out.good()) {
+        throw runtime_error("写入轨迹表文件失败: " + path);
+    }
+    return count;
+}
+
+bool WalkTable::open(const string& path) {
+    close();
+
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    // Windows下直接把文件读入内存
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    fileData.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    data = fileData.data();
+    size = fileData.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_BYTES)) {
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    mappedData = mapped;
+    mappedSize = size;
+    data = static_cast<const unsigned char*>(mapped);
+#endif
+
+    // 校验文件头和文件长度
+    if (size < HEADER_BYTES || memcmp(data, WALK_TABLE_MAGIC, 4) != 0 ||
+        readUint32(data + 4) != WALK_TABLE_VERSION) {
+        close();
+        return false;
+    }
+    uint32_t latticeType = readUint32(data + 8);
+    uint32_t stepField = readUint32(data + 12);
+    uint32_t bitField = readUint32(data + 16);
+    uint32_t recordField = readUint32(data + 20);
+    walkCount = readUint64(data + 24);
+
+    // 解码时按这些字段移位和查方向表，必须与build()写出的完全一致：
+    // 每步位数由格点类型决定，整条记录不超过64位，记录长度恰好容纳全部步
+    complex = latticeType == 1;
+    int expectedBits = complex ? HexLattice6::DIRECTION_BITS : SquareLattice4::DIRECTION_BITS;
+    if (latticeType > 1 || bitField != static_cast<uint32_t>(expectedBits) || stepField == 0 ||
+        stepField * bitField > 64 || recordField != (stepField * bitField + 7) / 8) {
+        close();
+        return false;
+    }
+    steps = static_cast<int>(stepField);
+    bitsPerStep = static_cast<int>(bitField);
+    recordBytes = static_cast<int>(recordField);
+    if ((size - HEADER_BYTES) / recordBytes < walkCount) {
+        close();
+        return false;
+    }
+    records = data + HEADER_BYTES;
+    return true;
+}
+
+uint64_t WalkTable::getWalkCount() const {
+    return walkCount;
+}
+
+int WalkTable::getSteps() const {
+    return steps;
+}
+
+bool WalkTable::isComplex() const {
+    return complex;
+}
+
+int WalkTable::getDirection(uint64_t index, int step) const {
+    const unsigned char* record = records + index * recordBytes;
+    int bit = step * bitsPerStep;
+    // 一个方向最多3位，最多跨两个字节
+    unsigned int window = record[bit >> 3];
+    if ((bit >> 3) + 1 < recordBytes) {
+        window |= static_cast<unsigned int>(record[(bit >> 3) + 1]) << 8;
+    }
+    return (window >> (bit & 7)) & ((1u << bitsPerStep) - 1);
+}
+
+void WalkTable::decode(uint64_t index, const GridCell& start, Trajectory& trajectory) const {
+    // 整条记录读成一个64位整数，再逐步取出方向
+    const unsigned char* record = records + index * recordBytes;
+    uint64_t code = 0;
+    for (int i = recordBytes - 1; i >= 0; i--) {
+        code = (code << 8) | record[i];
+    }
+
+    trajectory.clear();
+    trajectory.reserve(steps + 1);
+    trajectory.addCell(start);
+    GridCell cell = start;
+    uint64_t mask = (1u << bitsPerStep) - 1;
+    int directionCount = complex ? HexLattice6::DIRECTION_COUNT : SquareLattice4::DIRECTION_COUNT;
+    for (int k = 0; k < steps; k++) {
+        int dir = static_cast<int>((code >> (k * bitsPerStep)) & mask);
+        // 六边形每步3位，损坏的记录可能出现6、7这样不存在的方向
+        if (dir >= directionCount) {
+            throw runtime_error("轨迹表记录损坏：方向超出格点的方向数");
+        }
+        cell = complex ? latticeStep<HexLattice6>(cell, dir) : latticeStep<SquareLattice4>(cell, dir);
+        trajectory.addCell(cell);
+    }
+}
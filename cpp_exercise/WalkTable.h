@@ -0,0 +1,66 @@
+#pragma once
+#include "GridCell.h"
+#include "Trajectory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 自回避轨迹表：离线枚举某种格点、某个步数下的全部自回避轨迹，存成文件后内存映射使用
+// 每条轨迹只记录方向序列（方格每步2位，六边形每步3位），按记录定长存放，
+// 因此可以用一个随机下标直接取出一条轨迹，不需要回溯
+//
+// 文件格式（小端）：
+//   [0, 4)   魔数 "TWLK"
+//   [4, 8)   版本号
+//   [8, 12)  格点类型（0 方格，1 六边形）
+//   [12, 16) 步数
+//   [16, 20) 每步位数
+//   [20, 24) 每条记录的字节数
+//   [24, 32) 轨迹条数
+//   [32, ...) 记录，第k步的方向位于记录的第 k*每步位数 位
+class WalkTable {
+private:
+    const unsigned char* records;   // 第一条记录的地址（指向映射区域）
+    uint64_t walkCount;             // 轨迹条数
+    int steps;                      // 每条轨迹的步数
+    bool complex;                   // 是否为六边形格点
+    int bitsPerStep;                // 每步占用的位数
+    int recordBytes;                // 每条记录占用的字节数
+
+    void* mappedData;               // 映射的起始地址
+    size_t mappedSize;              // 映射的长度
+    std::vector<unsigned char> fileData;    // 不支持内存映射的平台上读入内存的文件内容
+
+    void close();
+
+public:
+    static const size_t HEADER_BYTES = 32;
+
+    WalkTable();
+    ~WalkTable();
+
+    // 表持有映射区域，不允许复制
+    WalkTable(const WalkTable&) = delete;
+    WalkTable& operator=(const WalkTable&) = delete;
+
+    // 枚举isComplex格点上steps步的全部自回避轨迹（只保留能放进棋盘的）并写入文件
+    // 返回轨迹条数；步数超出单条记录的容量时抛出std::invalid_argument，写文件失败时抛出std::runtime_error
+    static uint64_t build(const std::string& path, bool isComplex, int steps);
+
+    // 打开并映射表文件，文件不存在或格式不对时返回false
+    // 文件头的格点类型、步数、每步位数和记录长度必须与build()写出的一致，否则视为格式不对
+    bool open(const std::string& path);
+
+    // 获取表的基本信息
+    uint64_t getWalkCount() const;
+    int getSteps() const;
+    bool isComplex() const;
+
+    // 取出第index条轨迹的第step步方向
+    int getDirection(uint64_t index, int step) const;
+
+    // 把第index条轨迹从start出发展开到trajectory中（覆盖原有内容）
+    // 记录中出现格点上不存在的方向时抛出std::runtime_error
+    void decode(uint64_t index, const GridCell& start, Trajectory& trajectory) const;
+};
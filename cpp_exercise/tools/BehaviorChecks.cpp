@@ -0,0 +1,276 @@
+// 行为检查：验证各个优化后的模块与原来的实现结果一致、对错误输入给出错误而不是崩溃
+// 用法: BehaviorChecks（全部通过时返回0，否则输出失败的检查并返回1）
+// 编译: g++ -std=c++17 -O2 -pthread -I.. BehaviorChecks.cpp $(ls ../*.cpp | grep -v Main.cpp) -o BehaviorChecks
+#include "../GameObject.h"
+#include "../IncrementalScorer.h"
+#include "../Lattice.h"
+#include "../PackedTrajectory.h"
+#include "../PuzzleBatchGenerator.h"
+#include "../RandomEngine.h"
+#include "../SimilarityKernel.h"
+#include "../Trajectory.h"
+#include "../TrajectoryDistance.h"
+#include "../WalkTable.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const string& name) {
+    if (!condition) {
+        cerr << "失败: " << name << endl;
+        failures++;
+    }
+}
+
+// 检查expression抛出Exception类型的异常
+template <class Exception, class Function>
+static void checkThrows(Function expression, const string& name) {
+    try {
+        expression();
+    } catch (const Exception&) {
+        return;
+    } catch (...) {
+    }
+    check(false, name);
+}
+
+static void checkStartSeparation() {
+    GenerationOptions infeasible;
+    infeasible.minStartSeparation = GameObject::MAX_START_SEPARATION + 1;
+    infeasible.startSampling = REJECTION_START_SAMPLING;
+
+    PuzzleBatchGenerator batch(false, 10, 4);
+    checkThrows<invalid_argument>([&] { batch.setGenerationOptions(infeasible); }, "批量生成拒绝无法满足的起点间隔");
+    GameObject single;
+    checkThrows<invalid_argument>([&] { single.setGenerationOptions(infeasible); }, "单局生成拒绝无法满足的起点间隔");
+
+    // 最大的可行间隔下两种采样方式都能生成，且起点满足间隔要求
+    for (StartSampling sampling : {REJECTION_START_SAMPLING, DIRECT_START_SAMPLING}) {
+        GenerationOptions options;
+        options.minStartSeparation = GameObject::MAX_START_SEPARATION;
+        options.startSampling = sampling;
+        PuzzleBatchGenerator generator(true, 10, 4);
+        generator.setGenerationOptions(options);
+        generator.generate(200, 5);
+
+        bool separated = true;
+        for (size_t i = 0; i < generator.getPuzzleCount(); i++) {
+            GridCell actual = generator.getActualCells(i)[0];
+            GridCell relative = generator.getRelativeCells(i)[0];
+            separated = separated && (abs(actual.getRow() - relative.getRow()) >= options.minStartSeparation ||
+                                      abs(actual.getCol() - relative.getCol()) >= options.minStartSeparation);
+        }
+        check(separated, "相对轨迹起点满足间隔要求");
+    }
+}
+
+static void checkBatchDeterminism() {
+    // 第i局谜题只由基础种子和序号决定，与线程数和线程领取的顺序无关
+    for (bool isComplex : {false, true}) {
+        PuzzleBatchGenerator parallel(isComplex, 10, 4);
+        PuzzleBatchGenerator serial(isComplex, 10, 1);
+        parallel.generate(200, 5);
+        serial.generate(200, 5);
+        check(parallel.getPuzzleCount() == 200 && parallel.getCells() == serial.getCells(),
+              "批量生成的结果与线程数无关");
+    }
+}
+
+static void checkWalkTable() {
+    const string path = "BehaviorChecks.tbl";
+    WalkTable::build(path, true, 5);
+    auto table = make_shared<WalkTable>();
+    check(table->open(path) && table->getWalkCount() > 0, "打开刚生成的轨迹表");
+
+    GameObject puzzle;
+    GenerationOptions options;
+    options.walkStrategy = TABLE_SAMPLED_WALK;
+    options.walkTable = table;
+    puzzle.setGenerationOptions(options);
+    check(puzzle.generatePuzzle(true, 5), "按轨迹表生成谜题");
+    checkThrows<invalid_argument>([&] { puzzle.generatePuzzle(true, 6); }, "拒绝步数与谜题不一致的轨迹表");
+
+    // 逐个改坏文件头的字段：每步位数、步数、记录字节数、格点类型
+    ifstream in(path, ios::binary);
+    string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    const size_t offsets[] = {16, 16, 12, 20, 8};
+    const char values[] = {0, 2, 40, 9, 2};
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        string corrupt = data;
+        corrupt[offsets[i]] = values[i];
+        ofstream(path, ios::binary | ios::trunc).write(corrupt.data(), corrupt.size());
+        WalkTable reopened;
+        check(!reopened.open(path), "拒绝文件头损坏的轨迹表");
+    }
+    remove(path.c_str());
+}
+
+// 在isComplex格点上从start出发随机走steps步（不要求自回避），用于构造任意长度的轨迹
+static Trajectory randomWalk(RandomEngine& rng, bool isComplex, const GridCell& start, size_t steps) {
+    Trajectory trajectory;
+    trajectory.addCell(start);
+    GridCell cell = start;
+    for (size_t i = 0; i < steps; i++) {
+        cell = isComplex ? latticeStep<HexLattice6>(cell, rng.nextInt(HexLattice6::DIRECTION_COUNT))
+                         : latticeStep<SquareLattice4>(cell, rng.nextInt(SquareLattice4::DIRECTION_COUNT));
+        trajectory.addCell(cell);
+    }
+    return trajectory;
+}
+
+static PackedTrajectory readPacked(const string& data) {
+    istringstream in(data);
+    return PackedTrajectory::read(in);
+}
+
+static void checkPackedTrajectory() {
+    RandomEngine rng(1);
+    for (int complex = 0; complex < 2; complex++) {
+        // 跨过检查点间隔和64位字边界的长度
+        for (size_t steps : {size_t(0), size_t(1), size_t(21), size_t(63), size_t(64), size_t(65), size_t(300)}) {
+            Trajectory original = randomWalk(rng, complex == 1, GridCell(-3, 7), steps);
+            PackedTrajectory packed = PackedTrajectory::pack(original, complex == 1);
+            check(packed.unpack().getCells() == original.getCells(), "压缩后展开与原轨迹一致");
+
+            bool cellsMatch = true;
+            for (size_t i = 0; i < original.getLength(); i++) {
+                cellsMatch = cellsMatch && packed.getCell(i) == original.getCell(i);
+            }
+            check(cellsMatch, "按检查点随机访问与原轨迹一致");
+
+            ostringstream out;
+            packed.write(out);
+            check(readPacked(out.str()).unpack().getCells() == original.getCells(), "写入再读出与原轨迹一致");
+        }
+    }
+
+    // 格式：格点类型 | 起点行 | 起点列 | 长度 | 方向编号
+    checkThrows<runtime_error>([] { readPacked(string("\x02\x00\x00\x01", 4)); }, "拒绝未知的格点类型");
+    checkThrows<runtime_error>([] { readPacked(string("\x00\x00\x00\x0b\x55", 5)); }, "拒绝截断的方向数据");
+    checkThrows<runtime_error>([] { readPacked(string("\x00\x00\x00\xff\xff\xff\xff\xff\xff\xff\xff\x7f", 12)); },
+                               "拒绝超出上限的长度");
+    checkThrows<runtime_error>([] { readPacked(string("\x00\x00\x00\xff\xff\xff\xff\x0f", 8)); },
+                               "声明很长但数据截断时在读到结尾时失败");
+    // 六边形两步：方向编号7、0
+    checkThrows<runtime_error>([] { readPacked(string("\x01\x00\x00\x03\x07", 5)); }, "拒绝六边形上不存在的方向");
+}
+
+// 与trajectory等长、每格以一定概率与它重合的预测
+static Trajectory noisyCopy(RandomEngine& rng, const Trajectory& trajectory) {
+    Trajectory copy;
+    for (const GridCell& cell : trajectory.getCells()) {
+        copy.addCell(rng.nextInt(3) == 0 ? GridCell(cell.getRow() + 1, cell.getCol()) : cell);
+    }
+    return copy;
+}
+
+static void checkSimilarityKernel() {
+    RandomEngine rng(2);
+    const SimilarityKernel::Implementation kernels[] = {SimilarityKernel::SCALAR_KERNEL, SimilarityKernel::SSE2_KERNEL,
+                                                        SimilarityKernel::AVX2_KERNEL};
+    // 参与比较的格子数为0到3时只走尾部循环，其余长度覆盖整块加尾部
+    for (size_t referenceSteps : {size_t(1), size_t(2), size_t(3), size_t(4), size_t(9), size_t(33)}) {
+        Trajectory reference = randomWalk(rng, false, GridCell(0, 0), referenceSteps);
+        SimilarityKernel kernel(reference);
+        for (size_t length = 0; length <= referenceSteps + 3; length++) {
+            const size_t candidateCount = 7;
+            vector<GridCell> candidates;
+            vector<Trajectory> trajectories;
+            for (size_t k = 0; k < candidateCount; k++) {
+                Trajectory candidate = noisyCopy(rng, reference);
+                while (candidate.getLength() > length) {
+                    candidate.removeLastCell();
+                }
+                while (candidate.getLength() < length) {
+                    candidate.addCell(GridCell(99, 99));
+                }
+                candidates.insert(candidates.end(), candidate.getCells().begin(), candidate.getCells().end());
+                trajectories.push_back(candidate);
+            }
+
+            kernel.setImplementation(SimilarityKernel::SCALAR_KERNEL);
+            vector<uint32_t> expected = kernel.countMatches(candidates.data(), candidateCount, length);
+            for (SimilarityKernel::Implementation implementation : kernels) {
+                if (!SimilarityKernel::isSupported(implementation)) {
+                    continue;
+                }
+                kernel.setImplementation(implementation);
+                check(kernel.countMatches(candidates.data(), candidateCount, length) == expected,
+                      string(SimilarityKernel::implementationName(implementation)) + "内核与标量内核结果一致");
+            }
+
+            // Trajectory::calculateSimilarity要求两条轨迹都至少有两个格子
+            if (length >= 2) {
+                for (size_t k = 0; k < candidateCount; k++) {
+                    check(kernel.similarity(expected[k], length) == trajectories[k].calculateSimilarity(reference),
+                          "批量评分的相似度与calculateSimilarity一致");
+                }
+            }
+        }
+    }
+}
+
+static void checkTrajectoryDistance() {
+    RandomEngine rng(3);
+    for (int round = 0; round < 20; round++) {
+        Trajectory a = randomWalk(rng, round % 2 == 1, GridCell(0, 0), 5 + rng.nextInt(20));
+        Trajectory b = randomWalk(rng, round % 2 == 1, GridCell(1, 0), 5 + rng.nextInt(20));
+        int band = static_cast<int>(max(a.getLength(), b.getLength()));
+        check(dtwDistance(a, b, band) == dtwDistance(a, b), "带宽不小于长度时DTW与不限带宽一致");
+        check(frechetDistance(a, b, band) == frechetDistance(a, b), "带宽不小于长度时Fréchet与不限带宽一致");
+        check(dtwDistance(a, b, 1) >= dtwDistance(a, b), "限制带宽只会让DTW变大");
+
+        double exact = dtwDistance(a, b);
+        check(dtwDistance(a, b, DISTANCE_NO_BAND, exact) == exact, "不超过放弃阈值时DTW为精确值");
+        check(std::isinf(dtwDistance(a, b, DISTANCE_NO_BAND, exact / 2)) || exact == 0, "超过放弃阈值时DTW提前放弃");
+        check(dtwDistance(a, a) == 0 && frechetDistance(a, a) == 0 && hausdorffDistance(a, a) == 0,
+              "轨迹与自身的距离为0");
+    }
+}
+
+static void checkIncrementalScorer() {
+    RandomEngine rng(4);
+    for (int round = 0; round < 50; round++) {
+        Trajectory reference = randomWalk(rng, false, GridCell(0, 0), 1 + rng.nextInt(15));
+        Trajectory prediction = noisyCopy(rng, reference);
+        // 预测比最终轨迹长时多出的格子不计分
+        for (int extra = rng.nextInt(3); extra > 0; extra--) {
+            prediction.addCell(GridCell(50, 50));
+        }
+        IncrementalScorer scorer(reference);
+        for (const GridCell& cell : prediction.getCells()) {
+            scorer.addCell(cell);
+        }
+        check(scorer.getSimilarity() == prediction.calculateSimilarity(reference),
+              "逐步评分与calculateSimilarity一致");
+    }
+}
+
+int main() {
+    checkStartSeparation();
+    checkBatchDeterminism();
+    checkWalkTable();
+    checkPackedTrajectory();
+    checkSimilarityKernel();
+    checkTrajectoryDistance();
+    checkIncrementalScorer();
+
+    if (failures > 0) {
+        cerr << failures << " 项检查失败" << endl;
+        return 1;
+    }
+    cout << "全部检查通过" << endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+// 离线生成自回避轨迹表
+// 用法: BuildWalkTable <simple|complex> <steps> <output>
+// 编译: g++ -std=c++17 -O2 -I.. BuildWalkTable.cpp ../WalkTable.cpp ../OccupancyGrid.cpp ../Trajectory.cpp ../CellIndex.cpp ../TrajectoryDistance.cpp -o BuildWalkTable
+#include "../WalkTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        cerr << "用法: " << argv[0] << " <simple|complex> <steps> <output>" << endl;
+        return 1;
+    }
+    string mode = argv[1];
+    if (mode != "simple" && mode != "complex") {
+        cerr << "格点类型只能是simple或complex" << endl;
+        return 1;
+    }
+    bool isComplex = mode == "complex";
+    int steps = atoi(argv[2]);
+    string path = argv[3];
+
+    try {
+        auto begin = chrono::steady_clock::now();
+        uint64_t count = WalkTable::build(path, isComplex, steps);
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin);
+        cout << "已写入 " << count << " 条轨迹到 " << path << "，耗时 " << elapsed.count() << " ms" << endl;
+
+        // 重新打开文件校验一遍
+        WalkTable table;
+        if (!table.open(path) || table.getWalkCount() != count) {
+            cerr << "轨迹表校验失败" << endl;
+            return 1;
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}